@@ -11,6 +11,9 @@ void main()
 {
 	float nDot1 = max(dot(frag_Normal, -normalize(vec3(2, -5, 3))), 0.2);
 
-	out_Color = texture(u_Albedo, frag_TexCoord);
+	// greedy quads span several blocks, repeat the texture per block
+	// gradients come from the unwrapped coordinates so mip selection does not break at the seams
+	vec2 texCoord = frag_TexCoord.xy;
+	out_Color = textureGrad(u_Albedo, vec3(fract(texCoord), frag_TexCoord.z), dFdx(texCoord), dFdy(texCoord));
 	out_Color.rgb *= nDot1;
-}
\ No newline at end of file
+}
@@ -1,8 +1,8 @@
 #version 460 core
 
-layout (location = 0) in vec3 vert_Position;
-layout (location = 1) in vec3 vert_Normal;
-layout (location = 2) in vec3 vert_TexCoord;
+// x: position 6 bits per axis, face in bits 18-20, corner in bits 21-22
+// y: texture layer
+layout (location = 0) in uvec2 vert_Packed;
 
 out vec3 frag_TexCoord;
 out vec3 frag_Normal;
@@ -11,9 +11,41 @@ uniform mat4 u_View;
 uniform mat4 u_Model;
 uniform mat4 u_Projection;
 
+// world space origin of every chunk in the multi draw, indexed by gl_DrawID
+layout (std430, binding = 0) readonly buffer ChunkOrigins
+{
+	ivec4 s_ChunkOrigins[];
+};
+
+// indexed by face, in the order -x, +x, -y, +y, -z, +z
+const vec3 s_Normals[6] = vec3[](
+	vec3(-1, 0, 0), vec3(1, 0, 0),
+	vec3(0, -1, 0), vec3(0, 1, 0),
+	vec3(0, 0, -1), vec3(0, 0, 1)
+);
+
+// texture axes of each face, projecting the position onto them repeats the texture once per block
+const vec3 s_TexU[6] = vec3[](
+	vec3(0, 0, 1), vec3(0, 0, -1),
+	vec3(1, 0, 0), vec3(1, 0, 0),
+	vec3(-1, 0, 0), vec3(1, 0, 0)
+);
+
+const vec3 s_TexV[6] = vec3[](
+	vec3(0, 1, 0), vec3(0, 1, 0),
+	vec3(0, 0, 1), vec3(0, 0, -1),
+	vec3(0, 1, 0), vec3(0, 1, 0)
+);
+
 void main()
 {
-	gl_Position = u_Projection * u_View * u_Model * vec4(vert_Position, 1.0);
-	frag_Normal = vert_Normal;
-	frag_TexCoord = vert_TexCoord;
-}
\ No newline at end of file
+	uint packedPosition = vert_Packed.x;
+	vec3 position = vec3(packedPosition & 63u, (packedPosition >> 6) & 63u, (packedPosition >> 12) & 63u);
+	uint face = (packedPosition >> 18) & 7u;
+
+	vec3 origin = vec3(s_ChunkOrigins[gl_DrawID].xyz);
+
+	gl_Position = u_Projection * u_View * u_Model * vec4(origin + position, 1.0);
+	frag_Normal = s_Normals[face];
+	frag_TexCoord = vec3(dot(position, s_TexU[face]), dot(position, s_TexV[face]), float(vert_Packed.y));
+}
@@ -0,0 +1,184 @@
+#include "ChunkArena.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include "ChunkMesher.h"
+#include "Log.h"
+
+namespace FoxoCraft
+{
+	ChunkArena::ChunkArena(size_t capacity, GLuint quadIndices)
+	{
+		m_Capacity = capacity;
+		m_Free[0] = capacity;
+
+		glCreateBuffers(1, &m_Vbo);
+		glNamedBufferStorage(m_Vbo, m_Capacity * s_VertexSize, nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+		glCreateVertexArrays(1, &m_Vao);
+		glVertexArrayVertexBuffer(m_Vao, 0, m_Vbo, 0, s_VertexSize);
+		glEnableVertexArrayAttrib(m_Vao, 0);
+		glVertexArrayAttribIFormat(m_Vao, 0, 2, GL_UNSIGNED_INT, 0);
+		glVertexArrayAttribBinding(m_Vao, 0, 0);
+		glVertexArrayElementBuffer(m_Vao, quadIndices);
+
+		GLint alignment = 0;
+		glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		m_OriginsAlignment = std::max<size_t>(alignment, sizeof(glm::ivec4));
+	}
+
+	ChunkArena::~ChunkArena()
+	{
+		glDeleteVertexArrays(1, &m_Vao);
+		glDeleteBuffers(1, &m_Vbo);
+		Release(m_Commands);
+		Release(m_Origins);
+
+		for (GLsync fence : m_Fences)
+		{
+			if (fence) glDeleteSync(fence);
+		}
+	}
+
+	size_t ChunkArena::Allocate(size_t count)
+	{
+		if (count == 0) return s_InvalidOffset;
+
+		auto it = std::find_if(m_Free.begin(), m_Free.end(), [count](const auto& range) { return range.second >= count; });
+
+		if (it == m_Free.end())
+		{
+			Grow(std::max(m_Capacity * 2, m_Capacity + count));
+			return Allocate(count);
+		}
+
+		size_t offset = it->first;
+		size_t remaining = it->second - count;
+		m_Free.erase(it);
+
+		if (remaining != 0)
+			m_Free[offset + count] = remaining;
+
+		m_Used += count;
+		return offset;
+	}
+
+	void ChunkArena::Free(size_t offset, size_t count)
+	{
+		if (offset == s_InvalidOffset || count == 0) return;
+
+		m_Used -= count;
+
+		auto next = m_Free.lower_bound(offset);
+
+		if (next != m_Free.end() && offset + count == next->first)
+		{
+			count += next->second;
+			next = m_Free.erase(next);
+		}
+
+		if (next != m_Free.begin())
+		{
+			auto prev = std::prev(next);
+
+			if (prev->first + prev->second == offset)
+			{
+				prev->second += count;
+				return;
+			}
+		}
+
+		m_Free[offset] = count;
+	}
+
+	void ChunkArena::Upload(size_t offset, const uint32_t* vertices, size_t count)
+	{
+		glNamedBufferSubData(m_Vbo, offset * s_VertexSize, count * s_VertexSize, vertices);
+	}
+
+	void ChunkArena::Draw(const std::vector<DrawCommand>& commands, const std::vector<glm::ivec4>& origins)
+	{
+		if (commands.empty()) return;
+
+		size_t section = m_Section;
+		m_Section = (m_Section + 1) % s_FrameCount;
+
+		// overwriting a section the gpu still reads would race it, by now the wait is almost always free
+		if (m_Fences[section])
+		{
+			glClientWaitSync(m_Fences[section], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+			glDeleteSync(m_Fences[section]);
+			m_Fences[section] = nullptr;
+		}
+
+		size_t commandsSize = commands.size() * sizeof(DrawCommand);
+		size_t originsSize = origins.size() * sizeof(glm::ivec4);
+
+		// recreated buffers are new storage, draws in flight keep reading the old one
+		Reserve(m_Commands, commandsSize, sizeof(DrawCommand));
+		Reserve(m_Origins, originsSize, m_OriginsAlignment);
+
+		size_t commandsOffset = section * m_Commands.m_SectionSize;
+		size_t originsOffset = section * m_Origins.m_SectionSize;
+
+		// coherent mappings, the writes are visible to the draw without a flush
+		std::memcpy(m_Commands.m_Data + commandsOffset, commands.data(), commandsSize);
+		std::memcpy(m_Origins.m_Data + originsOffset, origins.data(), originsSize);
+
+		glBindVertexArray(m_Vao);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_Commands.m_Buffer);
+		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, m_Origins.m_Buffer, originsOffset, originsSize);
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<const void*>(commandsOffset), static_cast<GLsizei>(commands.size()), 0);
+
+		m_Fences[section] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	void ChunkArena::Reserve(StreamBuffer& buffer, size_t size, size_t alignment)
+	{
+		if (size <= buffer.m_SectionSize) return;
+
+		Release(buffer);
+
+		size_t sectionSize = std::max(size, buffer.m_SectionSize * 2);
+		buffer.m_SectionSize = (sectionSize + alignment - 1) / alignment * alignment;
+
+		constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glCreateBuffers(1, &buffer.m_Buffer);
+		glNamedBufferStorage(buffer.m_Buffer, buffer.m_SectionSize * s_FrameCount, nullptr, flags);
+		buffer.m_Data = static_cast<uint8_t*>(glMapNamedBufferRange(buffer.m_Buffer, 0, buffer.m_SectionSize * s_FrameCount, flags));
+	}
+
+	void ChunkArena::Release(StreamBuffer& buffer)
+	{
+		if (buffer.m_Buffer == 0) return;
+
+		glUnmapNamedBuffer(buffer.m_Buffer);
+		glDeleteBuffers(1, &buffer.m_Buffer);
+		buffer.m_Buffer = 0;
+		buffer.m_Data = nullptr;
+	}
+
+	void ChunkArena::Grow(size_t capacity)
+	{
+		FC_LOG_INFO("Growing chunk arena from {} to {} MiB", m_Capacity * s_VertexSize >> 20, capacity * s_VertexSize >> 20);
+
+		GLuint vbo;
+		glCreateBuffers(1, &vbo);
+		glNamedBufferStorage(vbo, capacity * s_VertexSize, nullptr, GL_DYNAMIC_STORAGE_BIT);
+		glCopyNamedBufferSubData(m_Vbo, vbo, 0, 0, m_Capacity * s_VertexSize);
+		glDeleteBuffers(1, &m_Vbo);
+
+		m_Vbo = vbo;
+		glVertexArrayVertexBuffer(m_Vao, 0, m_Vbo, 0, s_VertexSize);
+
+		// the new space extends the last free range if it ended at the old capacity
+		if (!m_Free.empty() && std::prev(m_Free.end())->first + std::prev(m_Free.end())->second == m_Capacity)
+			std::prev(m_Free.end())->second += capacity - m_Capacity;
+		else
+			m_Free[m_Capacity] = capacity - m_Capacity;
+
+		m_Capacity = capacity;
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+namespace FoxoCraft
+{
+	// Layout of glMultiDrawElementsIndirect commands
+	struct DrawCommand
+	{
+		GLuint m_Count = 0;
+		GLuint m_InstanceCount = 1;
+		GLuint m_FirstIndex = 0;
+		GLint m_BaseVertex = 0;
+		GLuint m_BaseInstance = 0;
+	};
+
+	// Vertex buffer shared by every chunk mesh, sub allocated with a first fit free list
+	// Offsets and sizes are in vertices so an allocation can be used directly as the base vertex of a draw
+	// The buffer doubles when it runs out of space, offsets stay valid across growth
+	// All functions must be called on the main thread
+	class ChunkArena final
+	{
+	public:
+		static constexpr size_t s_InvalidOffset = SIZE_MAX;
+
+		// quadIndices is bound as the element buffer of the arena's vao
+		ChunkArena(size_t capacity, GLuint quadIndices);
+		~ChunkArena();
+
+		ChunkArena(const ChunkArena&) = delete;
+		ChunkArena& operator=(const ChunkArena&) = delete;
+
+		// Returns the offset of count free vertices
+		size_t Allocate(size_t count);
+		void Free(size_t offset, size_t count);
+
+		// Writes count packed vertices at offset
+		void Upload(size_t offset, const uint32_t* vertices, size_t count);
+
+		// Draws every command with a single multi draw, origins[i] is the world space origin of commands[i]
+		// The origins are read in chunk.vert through gl_DrawID
+		// Commands and origins go to the next section of persistently mapped ring buffers, only waiting if the gpu
+		// still reads the section written s_FrameCount draws ago
+		void Draw(const std::vector<DrawCommand>& commands, const std::vector<glm::ivec4>& origins);
+
+		GLuint GetVao() const { return m_Vao; }
+		size_t GetCapacity() const { return m_Capacity; }
+		size_t GetUsed() const { return m_Used; }
+		size_t GetFreeBlocks() const { return m_Free.size(); }
+	private:
+		static constexpr size_t s_FrameCount = 3;
+
+		// Persistently mapped buffer of s_FrameCount sections, one written per draw
+		struct StreamBuffer
+		{
+			GLuint m_Buffer = 0;
+			uint8_t* m_Data = nullptr;
+			size_t m_SectionSize = 0;
+		};
+
+		void Grow(size_t capacity);
+
+		// Recreates buffer with sections of at least size bytes if they are smaller, section offsets are multiples of alignment
+		static void Reserve(StreamBuffer& buffer, size_t size, size_t alignment);
+		static void Release(StreamBuffer& buffer);
+
+		GLuint m_Vbo = 0;
+		GLuint m_Vao = 0;
+		size_t m_Capacity = 0;
+		size_t m_Used = 0;
+
+		// per frame draw commands and chunk origins, m_Fences[i] is signaled once the draw reading section i is done
+		StreamBuffer m_Commands;
+		StreamBuffer m_Origins;
+		size_t m_OriginsAlignment = 0;
+		std::array<GLsync, s_FrameCount> m_Fences = {};
+		size_t m_Section = 0;
+
+		// offset to size of every free range, neighboring ranges are always merged
+		std::map<size_t, size_t> m_Free;
+	};
+}
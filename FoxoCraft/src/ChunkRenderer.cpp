@@ -0,0 +1,144 @@
+#include "ChunkRenderer.h"
+
+#include <chrono>
+
+#include "ChunkMesher.h"
+#include "Log.h"
+#include <FoxoCommons/FrustumCull.h>
+
+namespace FoxoCraft
+{
+	ChunkRenderer::ChunkRenderer()
+	{
+		std::vector<uint32_t> indices = Faces::BuildQuadIndices(s_MaxChunkQuads);
+
+		glCreateBuffers(1, &m_QuadIndices);
+		glNamedBufferStorage(m_QuadIndices, indices.size() * sizeof(uint32_t), indices.data(), GL_NONE);
+
+		// 16 MiB to start with, enough for a few hundred chunks of terrain
+		m_Arena = std::make_unique<ChunkArena>((16 << 20) / s_VertexSize, m_QuadIndices);
+	}
+
+	ChunkRenderer::~ChunkRenderer()
+	{
+		m_Arena.reset();
+		glDeleteBuffers(1, &m_QuadIndices);
+	}
+
+	void ChunkRenderer::Upload(const ChunkMesh& mesh)
+	{
+		Free(mesh.m_Pos);
+
+		// no data was in the chunk, dont allocate gpu memory
+		size_t offset = m_Arena->Allocate(mesh.m_Count);
+		if (offset == ChunkArena::s_InvalidOffset) return;
+
+		m_Arena->Upload(offset, mesh.m_Vertices.data(), mesh.m_Count);
+		m_Allocations.Insert(mesh.m_Pos, { offset, mesh.m_Count, mesh.m_NaiveCount });
+	}
+
+	void ChunkRenderer::Free(glm::ivec3 cs)
+	{
+		ChunkAllocation* allocation = m_Allocations.Find(cs);
+		if (!allocation) return;
+
+		m_Arena->Free(allocation->m_Offset, allocation->m_Count);
+		m_Allocations.Erase(cs);
+	}
+
+	void ChunkRenderer::UploadMeshes(World& world, DebugData& data)
+	{
+		FC_PROFILE_SCOPE("Upload meshes");
+
+		world.TakeMeshes(m_Meshed);
+
+		for (auto& mesh : m_Meshed)
+			m_UploadQueue.push_back(std::move(mesh));
+
+		m_Meshed.clear();
+
+		auto start = std::chrono::steady_clock::now();
+		double elapsed = 0.0;
+		size_t uploads = 0;
+
+		// always upload at least one mesh so a tiny budget still makes progress
+		while (!m_UploadQueue.empty() && (uploads == 0 || elapsed < m_UploadBudget || m_UploadAll))
+		{
+			ChunkMesh mesh = std::move(m_UploadQueue.front());
+			m_UploadQueue.pop_front();
+
+			// meshes of unloaded chunks or meshes already superseded by a newer revision are dropped
+			Chunk* chunk = world.GetChunk(mesh.m_Pos);
+			if (chunk && chunk->m_MeshRevision == mesh.m_Revision)
+			{
+				Upload(mesh);
+				++uploads;
+			}
+
+			world.RecycleMesh(mesh);
+
+			elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		data.uploadsQueued = m_UploadQueue.size();
+		data.uploadTime = elapsed;
+	}
+
+	void ChunkRenderer::Render(World& world, const glm::mat4& projView, DebugData& data)
+	{
+		Frustum f(projView);
+
+		UploadMeshes(world, data);
+
+		data.chunksRendered = 0;
+		data.vertices = 0;
+		data.verticesNaive = 0;
+		data.vertexBytes = 0;
+		data.indexBytes = s_MaxChunkQuads * 6 * sizeof(uint32_t);
+		data.arenaUsed = m_Arena->GetUsed() * s_VertexSize;
+		data.arenaCapacity = m_Arena->GetCapacity() * s_VertexSize;
+		data.arenaFreeBlocks = m_Arena->GetFreeBlocks();
+
+		m_DrawCommands.clear();
+		m_DrawOrigins.clear();
+		m_Unloaded.clear();
+
+		{
+			FC_PROFILE_SCOPE("Cull chunks");
+
+			for (auto& [k, v] : m_Allocations)
+			{
+				if (!world.GetChunk(k))
+				{
+					m_Unloaded.push_back(k);
+					continue;
+				}
+
+				data.vertices += v.m_Count;
+				data.verticesNaive += v.m_NaiveCount;
+				data.vertexBytes += v.m_Count * s_VertexSize;
+
+				glm::vec3 chunkMin = k;
+				chunkMin *= static_cast<float>(s_ChunkSize);
+				glm::vec3 chunkMax = chunkMin + static_cast<float>(s_ChunkSize);
+
+				if (f.IsBoxVisible(chunkMin, chunkMax))
+				{
+					DrawCommand command;
+					command.m_Count = v.m_Count / 4 * 6;
+					command.m_BaseVertex = static_cast<GLint>(v.m_Offset);
+
+					++data.chunksRendered;
+					m_DrawCommands.push_back(command);
+					m_DrawOrigins.push_back(glm::ivec4(k * static_cast<int>(s_ChunkSize), 0));
+				}
+			}
+
+			for (glm::ivec3 cs : m_Unloaded)
+				Free(cs);
+		}
+
+		FC_PROFILE_SCOPE("Draw chunks");
+		m_Arena->Draw(m_DrawCommands, m_DrawOrigins);
+	}
+}
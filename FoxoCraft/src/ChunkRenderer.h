@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+#include "Chunk.h"
+#include "ChunkArena.h"
+#include "ChunkMap.h"
+#include "DebugInfo.h"
+
+namespace FoxoCraft
+{
+	// GPU side of a World, the world itself never touches gl
+	// Owns the vertex arena and the arena allocation of every meshed chunk, keyed by chunk position
+	// Allocations of chunks the world no longer has are freed on the next Render
+	// Needs a current gl context for its whole lifetime, main thread only
+	class ChunkRenderer final
+	{
+	public:
+		ChunkRenderer();
+		~ChunkRenderer();
+
+		ChunkRenderer(const ChunkRenderer&) = delete;
+		ChunkRenderer& operator=(const ChunkRenderer&) = delete;
+
+		// Uploads the world's finished meshes within the upload budget and draws the visible chunks
+		void Render(World& world, const glm::mat4& projView, DebugData& data);
+
+		// seconds per frame spent on gpu uploads
+		double m_UploadBudget = 0.002;
+
+		// uploads every finished mesh in the frame it arrives instead of stopping at m_UploadBudget, see World::m_Lockstep
+		bool m_UploadAll = false;
+	private:
+		struct ChunkAllocation
+		{
+			// first vertex of the mesh in m_Arena, m_Count vertices are allocated
+			size_t m_Offset = ChunkArena::s_InvalidOffset;
+			int m_Count = 0;
+			int m_NaiveCount = 0;
+		};
+
+		void UploadMeshes(World& world, DebugData& data);
+
+		// Replaces the chunk's vertices in the arena, chunks without vertices lose their allocation
+		void Upload(const ChunkMesh& mesh);
+
+		void Free(glm::ivec3 cs);
+
+		// index buffer for s_MaxChunkQuads quads used by every chunk draw
+		GLuint m_QuadIndices = 0;
+		std::unique_ptr<ChunkArena> m_Arena;
+
+		ChunkMap<ChunkAllocation> m_Allocations;
+
+		std::vector<ChunkMesh> m_Meshed;
+		std::deque<ChunkMesh> m_UploadQueue;
+
+		// rebuilt every frame from the visible chunks
+		std::vector<DrawCommand> m_DrawCommands;
+		std::vector<glm::ivec4> m_DrawOrigins;
+		std::vector<glm::ivec3> m_Unloaded;
+	};
+}
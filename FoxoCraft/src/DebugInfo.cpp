@@ -23,13 +23,37 @@ void DebugData::Draw()
 		int zl = zi - zc * FoxoCraft::s_ChunkSize;
 
 		ImGui::Text("%i fps", static_cast<int>(ImGui::GetIO().Framerate));
-		ImGui::Text("C: %i/%i", chunksRendered, chunksTotal);
+
+		// a frame is gpu bound when the passes take about as long as the whole frame
+		double frameTime = 1000.0 / ImGui::GetIO().Framerate;
+		double gpuTime = gpuClear.m_Avg + gpuChunks.m_Avg + gpuImGui.m_Avg;
+		ImGui::Text("GPU: %.2f ms of %.2f ms frame, %s bound", gpuTime, frameTime, gpuTime > frameTime * 0.9 ? "GPU" : "CPU");
+		ImGui::Text("GPU clear: %.3f / %.3f / %.3f ms min/avg/p99", gpuClear.m_Min, gpuClear.m_Avg, gpuClear.m_P99);
+		ImGui::Text("GPU chunks: %.3f / %.3f / %.3f ms min/avg/p99", gpuChunks.m_Min, gpuChunks.m_Avg, gpuChunks.m_P99);
+		ImGui::Text("GPU ImGui: %.3f / %.3f / %.3f ms min/avg/p99", gpuImGui.m_Min, gpuImGui.m_Avg, gpuImGui.m_P99);
+		ImGui::Text("C: %zu/%zu", chunksRendered, chunksTotal);
+		ImGui::Text("Uniform chunks: %zu", chunksUniform);
+		ImGui::Text("Streaming: %zu loading, %zu unloaded", chunksLoading, chunksUnloaded);
+		ImGui::Text("Chunk memory: %.1f KiB avg, %.1f MiB total", chunksTotal ? chunksMemory / 1024.0 / chunksTotal : 0.0, chunksMemory / (1024.0 * 1024.0));
+		ImGui::Text("Generation: %.3f ms/chunk, loading %.3f ms/chunk", generationTime * 1000.0, loadTime * 1000.0);
+		ImGui::Text("Storage: %zu loaded, %zu saved, %.1f KiB written", chunksLoaded, chunksSaved, bytesWritten / 1024.0);
+		ImGui::Text("Save queue: %zu/%zu", saveQueue, saveQueueCapacity);
+		ImGui::Text("Heightmaps: %zu cached, %zu hits, %zu misses", heightmapsCached, heightmapHits, heightmapMisses);
+		ImGui::Text("Meshing: %zu dirty, %.2f ms scheduling, %zu pending", meshQueue, meshScheduleTime * 1000.0, meshesPending);
+		ImGui::Text("Mesh allocations: %zu in %zu meshes", meshAllocations, meshesTaken);
+		ImGui::Text("Uploads: %zu queued, %.2f ms uploading", uploadsQueued, uploadTime * 1000.0);
+		ImGui::Text("Vertices: %zu, %zu without greedy meshing (%.1f%%)", vertices, verticesNaive, verticesNaive ? 100.0 * vertices / verticesNaive : 100.0);
+		ImGui::Text("Vertex memory: %.2f MiB, %.2f MiB without indices, %.2f MiB shared index buffer", vertexBytes / (1024.0 * 1024.0), vertexBytes * 1.5 / (1024.0 * 1024.0), indexBytes / (1024.0 * 1024.0));
+		ImGui::Text("Chunk arena: %.2f / %.2f MiB, %zu free blocks", arenaUsed / (1024.0 * 1024.0), arenaCapacity / (1024.0 * 1024.0), arenaFreeBlocks);
 		ImGui::Text("XYZ: %.3f / %.3f / %.3f", xf, yf, zf);
 		ImGui::Text("Block: %i %i %i", xi, yi, zi);
 		ImGui::Text("Chunk: %i %i %i in %i %i %i", xl, yl, zl, xc, yc, zc);
 
 		ImGui::Separator();
 		ImGui::Checkbox("Enable Wireframe", &enableWireframe);
+		ImGui::Checkbox("Enable Greedy Meshing", &enableGreedyMeshing);
+		ImGui::Checkbox("Show Profiler", &showProfiler);
+		ImGui::SliderInt("View Radius", &viewRadius, 2, 16);
 	}
 	ImGui::End();
 }
\ No newline at end of file
@@ -1,4 +1,8 @@
+#include <cstdlib>
+#include <string_view>
+
 #include "Sandbox.h"
+#include "Log.h"
 
 static FoxoCommons::Application* s_App;
 
@@ -10,9 +14,52 @@ namespace FoxoCommons
 	}
 }
 
-int main()
+// FoxoCraft [--benchmark [csv]] [--frames n] [--seed n] [--record file | --replay file]
+static FoxoCraft::LaunchOptions ParseOptions(int argc, char** argv)
 {
-	s_App = new FoxoCraft::Sandbox();
+	FoxoCraft::LaunchOptions options;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string_view arg = argv[i];
+		bool hasValue = i + 1 < argc && argv[i + 1][0] != '-';
+
+		if (arg == "--benchmark")
+		{
+			options.m_Benchmark = true;
+			if (hasValue) options.m_BenchmarkCsv = argv[++i];
+		}
+		else if (arg == "--frames" && hasValue)
+		{
+			// a benchmark without frames measures nothing, keep the default instead
+			char* end = nullptr;
+			unsigned long long frames = std::strtoull(argv[++i], &end, 10);
+
+			if (*end != '\0' || frames == 0)
+				FC_LOG_WARN("Invalid frame count: {}", argv[i]);
+			else
+				options.m_BenchmarkFrames = static_cast<size_t>(frames);
+		}
+		else if (arg == "--seed" && i + 1 < argc)
+			options.m_Seed = std::strtoll(argv[++i], nullptr, 10);
+		else if (arg == "--record" && hasValue)
+			options.m_Record = argv[++i];
+		else if (arg == "--replay" && hasValue)
+			options.m_Replay = argv[++i];
+		else
+			FC_LOG_WARN("Unknown argument: {}", arg);
+	}
+
+	return options;
+}
+
+int main(int argc, char** argv)
+{
+	FoxoCraft::Sandbox* sandbox = new FoxoCraft::Sandbox(ParseOptions(argc, argv));
+	s_App = sandbox;
 	s_App->Start();
+
+	int exitCode = sandbox->m_ExitCode;
 	delete s_App;
+	return exitCode;
 }
\ No newline at end of file
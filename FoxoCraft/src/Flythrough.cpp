@@ -0,0 +1,129 @@
+#include "Flythrough.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+#include <string>
+
+#include <glm/glm.hpp>
+
+#include "Log.h"
+
+namespace FoxoCraft
+{
+	// Position along the path after t seconds, sweeps sideways while moving along +x so new chunks keep streaming in
+	static glm::vec3 PathPosition(double t)
+	{
+		return glm::vec3(5.0 + 30.0 * t, 100.0 + 6.0 * std::sin(0.3 * t), 5.0 + 80.0 * std::sin(0.1 * t));
+	}
+
+	static glm::vec3 PathVelocity(double t)
+	{
+		return glm::vec3(30.0, 1.8 * std::cos(0.3 * t), 8.0 * std::cos(0.1 * t));
+	}
+
+	Flythrough::Flythrough(size_t frames)
+		: m_Frames(frames)
+	{
+		m_FrameTimes.reserve(frames);
+		m_Draws.reserve(frames);
+	}
+
+	void Flythrough::Step(FoxoCommons::Transform& body, FoxoCommons::Transform& head)
+	{
+		double t = m_Step * s_TimeStep;
+		++m_Step;
+
+		glm::vec3 velocity = PathVelocity(t);
+
+		// the camera looks down -z, turn it to face along the path
+		body = FoxoCommons::Transform();
+		body.m_Pos = PathPosition(t);
+		body.Rotate(std::atan2(-velocity.x, -velocity.z), glm::vec3(0, 1, 0));
+
+		head = FoxoCommons::Transform();
+		head.Rotate(glm::radians(-20.0f), glm::vec3(1, 0, 0));
+	}
+
+	void Flythrough::Record(const DebugData& data)
+	{
+		auto now = std::chrono::steady_clock::now();
+
+		// the first frame has nothing to measure against
+		if (m_Started)
+		{
+			m_FrameTimes.push_back(std::chrono::duration<double, std::milli>(now - m_LastFrame).count());
+			m_Draws.push_back(data.chunksRendered);
+			m_Vertices += data.vertices;
+		}
+
+		m_LastFrame = now;
+		m_Started = true;
+	}
+
+	bool Flythrough::IsDone() const
+	{
+		return m_FrameTimes.size() >= m_Frames;
+	}
+
+	double Flythrough::GetFrameTime(double percentile) const
+	{
+		if (m_FrameTimes.empty()) return 0.0;
+
+		std::vector<double> sorted = m_FrameTimes;
+		std::sort(sorted.begin(), sorted.end());
+
+		size_t index = static_cast<size_t>(percentile * (sorted.size() - 1) + 0.5);
+		return sorted[std::min(index, sorted.size() - 1)];
+	}
+
+	bool Flythrough::WriteCsv(const std::filesystem::path& path, int64_t seed, const World& world, std::string_view renderer) const
+	{
+		size_t frames = m_FrameTimes.size();
+		if (!frames)
+		{
+			FC_LOG_ERROR("No frames recorded, not writing {}", path.u8string());
+			return false;
+		}
+
+		std::error_code ec;
+		bool exists = std::filesystem::exists(path, ec);
+
+		std::ofstream file(path, std::ios::app);
+		if (!file)
+		{
+			FC_LOG_ERROR("Failed to open {}", path.u8string());
+			return false;
+		}
+
+		if (!exists)
+			file << "seed,frames,timestep_ms,frame_avg_ms,frame_p50_ms,frame_p90_ms,frame_p99_ms,frame_max_ms,chunks_generated,chunks_meshed,draws_avg,draws_max,vertices_avg,renderer\n";
+
+		double frameAvg = std::accumulate(m_FrameTimes.begin(), m_FrameTimes.end(), 0.0) / frames;
+		double drawsAvg = static_cast<double>(std::accumulate(m_Draws.begin(), m_Draws.end(), size_t(0))) / frames;
+		size_t drawsMax = *std::max_element(m_Draws.begin(), m_Draws.end());
+
+		// the renderer string may contain commas, quote it and drop any quotes inside
+		std::string quoted;
+		for (char c : renderer)
+			if (c != '"') quoted += c;
+
+		file << seed << ','
+			<< frames << ','
+			<< s_TimeStep * 1000.0 << ','
+			<< frameAvg << ','
+			<< GetFrameTime(0.5) << ','
+			<< GetFrameTime(0.9) << ','
+			<< GetFrameTime(0.99) << ','
+			<< GetFrameTime(1.0) << ','
+			<< world.m_ChunksGenerated << ','
+			<< world.m_ChunksMeshed << ','
+			<< drawsAvg << ','
+			<< drawsMax << ','
+			<< m_Vertices / frames << ','
+			<< '"' << quoted << "\"\n";
+
+		return static_cast<bool>(file);
+	}
+}
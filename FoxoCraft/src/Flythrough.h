@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+#include <FoxoCommons/Transform.h>
+
+#include "Chunk.h"
+#include "DebugInfo.h"
+
+namespace FoxoCraft
+{
+	// Scripted camera for the --benchmark mode, flies a fixed parametric path
+	// Time only advances by s_TimeStep per frame, a slow frame does not skip ahead on the path
+	// The world runs in lockstep meanwhile so every run streams, meshes and draws the same chunks each frame, see World::m_Lockstep
+	class Flythrough final
+	{
+	public:
+		static constexpr double s_TimeStep = 1.0 / 60.0;
+
+		explicit Flythrough(size_t frames);
+
+		// Places the player's body and head transforms for the current frame and advances the path by one step
+		void Step(FoxoCommons::Transform& body, FoxoCommons::Transform& head);
+
+		// Measures the wall time since the previous call and keeps the draw counts of the frame just rendered
+		void Record(const DebugData& data);
+
+		bool IsDone() const;
+
+		size_t GetFrameCount() const
+		{
+			return m_FrameTimes.size();
+		}
+
+		// Appends one row to the csv, the header is only written when the file is new
+		bool WriteCsv(const std::filesystem::path& path, int64_t seed, const World& world, std::string_view renderer) const;
+
+		// Frame time percentiles in milliseconds
+		double GetFrameTime(double percentile) const;
+	private:
+		size_t m_Frames;
+		size_t m_Step = 0;
+
+		std::chrono::steady_clock::time_point m_LastFrame;
+		bool m_Started = false;
+
+		std::vector<double> m_FrameTimes;
+		std::vector<size_t> m_Draws;
+		size_t m_Vertices = 0;
+	};
+}
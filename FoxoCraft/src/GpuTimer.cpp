@@ -0,0 +1,73 @@
+#include "GpuTimer.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace FoxoCraft
+{
+	GpuTimer::GpuTimer()
+	{
+		glCreateQueries(GL_TIME_ELAPSED, static_cast<GLsizei>(m_Queries.size()), m_Queries.data());
+	}
+
+	GpuTimer::~GpuTimer()
+	{
+		glDeleteQueries(static_cast<GLsizei>(m_Queries.size()), m_Queries.data());
+	}
+
+	void GpuTimer::Begin()
+	{
+		Poll();
+
+		if (m_Pending == s_QueryCount) return;
+
+		glBeginQuery(GL_TIME_ELAPSED, m_Queries[m_Next]);
+		m_Active = true;
+	}
+
+	void GpuTimer::End()
+	{
+		if (!m_Active) return;
+
+		glEndQuery(GL_TIME_ELAPSED);
+
+		m_Next = (m_Next + 1) % s_QueryCount;
+		++m_Pending;
+		m_Active = false;
+	}
+
+	void GpuTimer::Poll()
+	{
+		while (m_Pending != 0)
+		{
+			GLuint query = m_Queries[(m_Next + s_QueryCount - m_Pending) % s_QueryCount];
+
+			// queries finish in order, stop at the first one the gpu has not reached
+			GLint available = 0;
+			glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+			if (!available) break;
+
+			GLuint64 elapsed = 0;
+			glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+			--m_Pending;
+
+			m_History[m_HistoryNext] = elapsed / 1e6;
+			m_HistoryNext = (m_HistoryNext + 1) % s_HistorySize;
+			m_HistoryCount = std::min(m_HistoryCount + 1, s_HistorySize);
+		}
+	}
+
+	TimingStats GpuTimer::GetStats() const
+	{
+		TimingStats stats;
+		if (m_HistoryCount == 0) return stats;
+
+		std::array<double, s_HistorySize> sorted = m_History;
+		std::sort(sorted.begin(), sorted.begin() + m_HistoryCount);
+
+		stats.m_Min = sorted[0];
+		stats.m_Avg = std::accumulate(sorted.begin(), sorted.begin() + m_HistoryCount, 0.0) / m_HistoryCount;
+		stats.m_P99 = sorted[std::min(m_HistoryCount - 1, m_HistoryCount * 99 / 100)];
+		return stats;
+	}
+}
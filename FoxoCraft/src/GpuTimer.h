@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include <glad/gl.h>
+
+#include "DebugInfo.h"
+
+namespace FoxoCraft
+{
+	// GL_TIME_ELAPSED timer around one render pass, measured every frame and kept as a rolling history
+	// Results are read back frames later once GL_QUERY_RESULT_AVAILABLE is set, the cpu never waits on the gpu
+	// When every query is still in flight the frame is skipped instead
+	// Passes timed by different GpuTimers must not overlap, only one GL_TIME_ELAPSED query can be active
+	class GpuTimer final
+	{
+	public:
+		GpuTimer();
+		~GpuTimer();
+
+		GpuTimer(const GpuTimer&) = delete;
+		GpuTimer& operator=(const GpuTimer&) = delete;
+
+		void Begin();
+		void End();
+
+		// Milliseconds over the last s_HistorySize measured frames
+		TimingStats GetStats() const;
+	private:
+		// Moves every finished query into the history, oldest first
+		void Poll();
+
+		// more than two so a gpu running a few frames behind does not drop samples
+		static constexpr size_t s_QueryCount = 4;
+		static constexpr size_t s_HistorySize = 240;
+
+		std::array<GLuint, s_QueryCount> m_Queries = {};
+		size_t m_Next = 0;
+		size_t m_Pending = 0;
+		bool m_Active = false;
+
+		std::array<double, s_HistorySize> m_History = {};
+		size_t m_HistoryCount = 0;
+		size_t m_HistoryNext = 0;
+	};
+}
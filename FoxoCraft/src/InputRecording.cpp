@@ -0,0 +1,124 @@
+#include "InputRecording.h"
+
+#include <fstream>
+#include <iterator>
+
+#include <glad/gl.h>
+#include <GLFW/glfw3.h>
+
+#include "ByteStream.h"
+#include "Log.h"
+
+namespace FoxoCraft
+{
+	InputFrame InputFrame::Poll(GLFWwindow* window, double deltaTime, glm::vec2 mouseDelta, bool active)
+	{
+		InputFrame frame;
+		frame.m_MouseDelta = mouseDelta;
+		frame.m_DeltaTime = static_cast<float>(deltaTime);
+
+		if (active) frame.m_Keys |= s_Active;
+		if (glfwGetKey(window, GLFW_KEY_W)) frame.m_Keys |= s_Forward;
+		if (glfwGetKey(window, GLFW_KEY_S)) frame.m_Keys |= s_Back;
+		if (glfwGetKey(window, GLFW_KEY_A)) frame.m_Keys |= s_Left;
+		if (glfwGetKey(window, GLFW_KEY_D)) frame.m_Keys |= s_Right;
+		if (glfwGetKey(window, GLFW_KEY_SPACE)) frame.m_Keys |= s_Jump;
+		if (glfwGetKey(window, GLFW_KEY_LEFT_CONTROL)) frame.m_Keys |= s_Run;
+
+		return frame;
+	}
+
+	void InputRecording::Add(const InputFrame& frame, glm::vec3 position)
+	{
+		m_Frames.push_back(frame);
+		m_Positions.push_back(position);
+	}
+
+	bool InputRecording::Save(const std::filesystem::path& path) const
+	{
+		std::vector<uint8_t> data;
+		ByteWriter writer(data);
+		writer.Write(s_Magic);
+		writer.Write(s_Version);
+		writer.Write(m_Seed);
+		writer.Write(m_Aspect);
+		writer.Write(m_ViewRadius);
+		writer.Write(static_cast<uint32_t>(m_Frames.size()));
+
+		// field by field, 25 bytes a frame without padding
+		for (size_t i = 0; i < m_Frames.size(); ++i)
+		{
+			writer.Write(m_Frames[i].m_Keys);
+			writer.Write(m_Frames[i].m_MouseDelta.x);
+			writer.Write(m_Frames[i].m_MouseDelta.y);
+			writer.Write(m_Frames[i].m_DeltaTime);
+			writer.Write(m_Positions[i].x);
+			writer.Write(m_Positions[i].y);
+			writer.Write(m_Positions[i].z);
+		}
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+		if (!file)
+		{
+			FC_LOG_ERROR("Failed to write input recording to {}", path.u8string());
+			return false;
+		}
+
+		return true;
+	}
+
+	bool InputRecording::Load(const std::filesystem::path& path)
+	{
+		m_Frames.clear();
+		m_Positions.clear();
+
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+		{
+			FC_LOG_ERROR("Failed to open input recording {}", path.u8string());
+			return false;
+		}
+
+		std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		ByteReader reader(data.data(), data.size());
+
+		if (reader.Read<uint32_t>() != s_Magic || reader.Read<uint32_t>() != s_Version)
+		{
+			FC_LOG_ERROR("{} is not an input recording", path.u8string());
+			return false;
+		}
+
+		m_Seed = reader.Read<int64_t>();
+		m_Aspect = reader.Read<float>();
+		m_ViewRadius = reader.Read<int32_t>();
+		uint32_t count = reader.Read<uint32_t>();
+
+		for (uint32_t i = 0; i < count && !reader.m_Failed; ++i)
+		{
+			InputFrame frame;
+			frame.m_Keys = reader.Read<uint8_t>();
+			frame.m_MouseDelta.x = reader.Read<float>();
+			frame.m_MouseDelta.y = reader.Read<float>();
+			frame.m_DeltaTime = reader.Read<float>();
+
+			glm::vec3 position;
+			position.x = reader.Read<float>();
+			position.y = reader.Read<float>();
+			position.z = reader.Read<float>();
+
+			Add(frame, position);
+		}
+
+		if (reader.m_Failed)
+		{
+			FC_LOG_ERROR("Input recording {} is truncated", path.u8string());
+			m_Frames.clear();
+			m_Positions.clear();
+			return false;
+		}
+
+		return true;
+	}
+}
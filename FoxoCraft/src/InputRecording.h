@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+struct GLFWwindow;
+
+namespace FoxoCraft
+{
+	// Everything Player::Update reads in one frame, live input and replays go through the same struct
+	struct InputFrame
+	{
+		static constexpr uint8_t s_Forward = 1 << 0;
+		static constexpr uint8_t s_Back = 1 << 1;
+		static constexpr uint8_t s_Left = 1 << 2;
+		static constexpr uint8_t s_Right = 1 << 3;
+		static constexpr uint8_t s_Jump = 1 << 4;
+		static constexpr uint8_t s_Run = 1 << 5;
+		// the mouse is locked to the window, the player ignores input otherwise
+		static constexpr uint8_t s_Active = 1 << 6;
+
+		uint8_t m_Keys = 0;
+		glm::vec2 m_MouseDelta = glm::vec2();
+		float m_DeltaTime = 0.f;
+
+		bool IsDown(uint8_t key) const
+		{
+			return (m_Keys & key) != 0;
+		}
+
+		static InputFrame Poll(GLFWwindow* window, double deltaTime, glm::vec2 mouseDelta, bool active);
+	};
+
+	// Input frames of one session with the player position after each, and the seed of the world they were recorded in
+	// Replaying the frames against the same seed repeats the session, the positions tell when a replay stopped matching
+	// The aspect and view radius decide which chunks stream in around the player, both are pinned while recording and replaying
+	// File: "FCIN", version, seed, aspect, view radius, frame count, then per frame keys, mouse delta, delta time and position
+	struct InputRecording
+	{
+		static constexpr uint32_t s_Magic = 0x4E494346; // FCIN
+		static constexpr uint32_t s_Version = 2;
+
+		int64_t m_Seed = 0;
+		float m_Aspect = 1.f;
+		int32_t m_ViewRadius = 0;
+		std::vector<InputFrame> m_Frames;
+		std::vector<glm::vec3> m_Positions;
+
+		void Add(const InputFrame& frame, glm::vec3 position);
+
+		bool Save(const std::filesystem::path& path) const;
+		bool Load(const std::filesystem::path& path);
+	};
+}
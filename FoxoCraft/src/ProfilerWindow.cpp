@@ -0,0 +1,102 @@
+#include "ProfilerWindow.h"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+
+#include <imgui.h>
+
+namespace FoxoCraft
+{
+	static constexpr float s_RowHeight = 18.0f;
+
+	// stable color per zone name so the same zone looks the same in every frame
+	static ImU32 GetZoneColor(const char* name)
+	{
+		size_t hash = std::hash<std::string>()(name);
+		return IM_COL32(90 + hash % 120, 90 + (hash >> 8) % 120, 90 + (hash >> 16) % 120, 255);
+	}
+
+	void ProfilerWindow::Draw(bool& open)
+	{
+		if (!open) return;
+
+		if (ImGui::Begin("Profiler", &open))
+		{
+			ImGui::Checkbox("Pause", &m_Paused);
+			ImGui::SameLine();
+
+			if (ImGui::Button("Export Chrome trace"))
+				Profiler::ExportChromeTrace("FoxoCraft/trace.json");
+
+			if (!m_Paused && Profiler::GetLastFrame(m_Begin, m_End))
+			{
+				m_Events.clear();
+				Profiler::Collect(m_Begin, m_End, m_Events);
+				m_Threads = Profiler::GetThreadNames();
+			}
+
+			double frameTime = (m_End - m_Begin) / 1e6;
+			ImGui::Text("Frame: %.2f ms", frameTime);
+
+			// time per zone name within the frame, zones on different threads add up so a total can exceed the frame
+			std::map<std::string, double> totals;
+			for (const Profiler::Event& event : m_Events)
+				totals[event.m_Name] += (std::min(event.m_End, m_End) - std::max(event.m_Start, m_Begin)) / 1e6;
+
+			if (ImGui::CollapsingHeader("Totals"))
+			{
+				for (auto& [name, time] : totals)
+					ImGui::Text("%s: %.3f ms", name.c_str(), time);
+			}
+
+			float width = ImGui::GetContentRegionAvail().x;
+			double scale = m_End > m_Begin ? width / static_cast<double>(m_End - m_Begin) : 0.0;
+
+			for (uint32_t thread = 0; thread < m_Threads.size(); ++thread)
+			{
+				uint32_t depth = 0;
+				bool any = false;
+
+				for (const Profiler::Event& event : m_Events)
+				{
+					if (event.m_Thread != thread) continue;
+					depth = std::max(depth, event.m_Depth + 1);
+					any = true;
+				}
+
+				if (!any) continue;
+
+				ImGui::TextUnformatted(m_Threads[thread].c_str());
+
+				ImVec2 origin = ImGui::GetCursorScreenPos();
+				ImGui::Dummy(ImVec2(width, depth * s_RowHeight));
+
+				ImDrawList* drawList = ImGui::GetWindowDrawList();
+				ImVec2 mouse = ImGui::GetIO().MousePos;
+
+				for (const Profiler::Event& event : m_Events)
+				{
+					if (event.m_Thread != thread) continue;
+
+					float x0 = origin.x + static_cast<float>((std::max(event.m_Start, m_Begin) - m_Begin) * scale);
+					float x1 = origin.x + static_cast<float>((std::min(event.m_End, m_End) - m_Begin) * scale);
+					float y0 = origin.y + event.m_Depth * s_RowHeight;
+					float y1 = y0 + s_RowHeight - 1.0f;
+
+					// zones shorter than a pixel still show up
+					x1 = std::max(x1, x0 + 1.0f);
+
+					drawList->AddRectFilled(ImVec2(x0, y0), ImVec2(x1, y1), GetZoneColor(event.m_Name));
+
+					if (x1 - x0 > ImGui::CalcTextSize(event.m_Name).x + 4.0f)
+						drawList->AddText(ImVec2(x0 + 2.0f, y0 + 2.0f), IM_COL32(0, 0, 0, 255), event.m_Name);
+
+					if (mouse.x >= x0 && mouse.x < x1 && mouse.y >= y0 && mouse.y < y1)
+						ImGui::SetTooltip("%s: %.3f ms", event.m_Name, (event.m_End - event.m_Start) / 1e6);
+				}
+			}
+		}
+		ImGui::End();
+	}
+}
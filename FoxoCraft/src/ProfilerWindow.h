@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Profiler.h"
+
+namespace FoxoCraft
+{
+	// ImGui window with the zones of the last frame, one flame graph row per thread, and the total time per zone name
+	// Main thread only
+	class ProfilerWindow final
+	{
+	public:
+		void Draw(bool& open);
+	private:
+		// keeps showing the same frame while set
+		bool m_Paused = false;
+
+		uint64_t m_Begin = 0;
+		uint64_t m_End = 0;
+		std::vector<Profiler::Event> m_Events;
+		std::vector<std::string> m_Threads;
+	};
+}
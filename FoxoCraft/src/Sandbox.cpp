@@ -33,9 +33,11 @@ Player::Player()
 	m_Transform.m_Pos = { 5, 60, 5 };
 }
 
-void Player::Update(GLFWwindow* window, double deltaTime, glm::vec2 mouseDelta, FoxoCraft::World& world)
+void Player::Update(const FoxoCraft::InputFrame& input, FoxoCraft::World& world)
 {
-	if (!MouseLock::IsLocked()) return;
+	FC_PROFILE_SCOPE("Player update");
+
+	if (!input.IsDown(FoxoCraft::InputFrame::s_Active)) return;
 
 	constexpr float sensitivity = 0.1f;
 	constexpr float gravity = -10.f;
@@ -43,23 +45,26 @@ void Player::Update(GLFWwindow* window, double deltaTime, glm::vec2 mouseDelta,
 	constexpr float runspeed = walkspeed * 2.f;
 	constexpr float jump = 5.f;
 
+	glm::vec2 mouseDelta = input.m_MouseDelta;
+	float deltaTime = input.m_DeltaTime;
+
 	if (mouseDelta.x != 0.f)
 		m_Transform.Rotate(glm::radians(mouseDelta.x * -sensitivity), glm::vec3(0, 1, 0));
 
 	if (mouseDelta.y != 0.f)
 		m_TransformExtra.Rotate(glm::radians(mouseDelta.y * -sensitivity), glm::vec3(1, 0, 0));
 
-	vel += gravity * static_cast<float>(deltaTime);
+	vel += gravity * deltaTime;
 
 	
 	glm::vec3 movement = glm::vec3(0.0f);
 
-	if (glfwGetKey(window, GLFW_KEY_W)) --movement.z;
-	if (glfwGetKey(window, GLFW_KEY_S)) ++movement.z;
-	if (glfwGetKey(window, GLFW_KEY_A)) --movement.x;
-	if (glfwGetKey(window, GLFW_KEY_D)) ++movement.x;
+	if (input.IsDown(FoxoCraft::InputFrame::s_Forward)) --movement.z;
+	if (input.IsDown(FoxoCraft::InputFrame::s_Back)) ++movement.z;
+	if (input.IsDown(FoxoCraft::InputFrame::s_Left)) --movement.x;
+	if (input.IsDown(FoxoCraft::InputFrame::s_Right)) ++movement.x;
 
-	if (glfwGetKey(window, GLFW_KEY_SPACE) && canJump)
+	if (input.IsDown(FoxoCraft::InputFrame::s_Jump) && canJump)
 	{
 		vel = jump;
 		canJump = false;
@@ -69,16 +74,16 @@ void Player::Update(GLFWwindow* window, double deltaTime, glm::vec2 mouseDelta,
 	//if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT)) --movement.y;
 
 	float speed = walkspeed;
-	if (glfwGetKey(window, GLFW_KEY_LEFT_CONTROL)) speed = runspeed;
+	if (input.IsDown(FoxoCraft::InputFrame::s_Run)) speed = runspeed;
 
 	if (glm::length2(movement) > 0)
-		movement = glm::normalize(movement) * speed * static_cast<float>(deltaTime);
+		movement = glm::normalize(movement) * speed * deltaTime;
 
 	glm::mat4 matrix = m_Transform.ToMatrix();
 	matrix = glm::translate(matrix, glm::vec3(movement));
 	FoxoCommons::Transform nextTransform;
 	nextTransform.FromMatrix(matrix);
-	nextTransform.m_Pos.y += vel * static_cast<float>(deltaTime);
+	nextTransform.m_Pos.y += vel * deltaTime;
 
 	glm::vec3& currentPos = m_Transform.m_Pos;
 	glm::vec3& nextPos = nextTransform.m_Pos;
@@ -189,27 +194,116 @@ namespace FoxoCraft
 
 		virtual void Init() override
 		{
-			int64_t seed = FoxoCommons::GenerateValue(std::numeric_limits<int64_t>::lowest(), std::numeric_limits<int64_t>::max());
+			Sandbox* game = GetStateManager()->GetUserPtr<Sandbox>();
+
+			const LaunchOptions& options = game->m_Options;
+
+			int64_t seed;
+			std::unique_ptr<WorldStorage> storage;
+
+			// benchmarks, recordings and replays never touch the saves, every run generates the same world from scratch
+			if (!options.m_Replay.empty() && LoadReplay(options.m_Replay))
+			{
+				seed = m_Recording->m_Seed;
+
+				// measures every frame until the recording runs out, the path is not flown
+				if (options.m_Benchmark)
+					m_Flythrough = std::make_unique<Flythrough>(m_Recording->m_Frames.size());
+			}
+			else if (options.m_Benchmark)
+			{
+				seed = options.m_Seed;
+				m_Flythrough = std::make_unique<Flythrough>(options.m_BenchmarkFrames);
+				FC_LOG_INFO("Benchmark: {} frames at a fixed {:.2f} ms step", options.m_BenchmarkFrames, Flythrough::s_TimeStep * 1000.0);
+			}
+			else if (!options.m_Record.empty())
+			{
+				seed = options.m_Seed;
+				m_Recording = std::make_unique<InputRecording>();
+				m_Recording->m_Seed = seed;
+				m_Recording->m_Aspect = game->m_Window.GetAspect();
+				m_Recording->m_ViewRadius = s_DebugData.viewRadius;
+				FC_LOG_INFO("Recording input to {}", options.m_Record.u8string());
+			}
+			else
+			{
+				const std::filesystem::path directory = "FoxoCraft/saves/world";
+
+				storage = std::make_unique<WorldStorage>(directory);
+				WorldStorage::InfoResult info = storage->LoadInfo(seed);
+
+				// a corrupt world is moved aside for recovery and a new one started in its place, it is never saved over
+				if (info == WorldStorage::InfoResult::Corrupt)
+				{
+					storage.reset();
+
+					std::error_code error;
+					std::filesystem::path aside = WorldStorage::MoveAside(directory, ".corrupt", error);
+
+					if (error)
+						FC_LOG_ERROR("Failed to move the corrupt world aside, nothing will be saved: {}", error.message());
+					else
+					{
+						FC_LOG_WARN("Moved the corrupt world to {}", aside.u8string());
+						storage = std::make_unique<WorldStorage>(directory);
+						info = storage->LoadInfo(seed);
+					}
+				}
+
+				if (info != WorldStorage::InfoResult::Loaded)
+					seed = FoxoCommons::GenerateValue(std::numeric_limits<int64_t>::lowest(), std::numeric_limits<int64_t>::max());
+
+				// rewritten every launch, LoadInfo may have added new blocks
+				if (storage)
+					storage->SaveInfo(seed);
+			}
+
 			FC_LOG_INFO("Using seed: {}", seed);
-			m_World = FoxoCraft::World(seed);
-			m_World.AddChunks();
+			m_Seed = seed;
+			m_World = std::make_unique<World>(seed, std::move(storage));
+			game->m_Game = this;
+			m_World->AddChunks(m_Player.m_Transform.m_Pos);
+			m_Renderer = std::make_unique<ChunkRenderer>();
+
+			// wall clock budgets would make the work done per frame depend on the machine
+			// benchmarks run in lockstep, and so do recordings and replays or the player would fall through different chunks each run
+			if (m_Flythrough || m_Recording)
+			{
+				m_World->m_Lockstep = true;
+				m_Renderer->m_UploadAll = true;
+			}
+			m_ClearTimer = std::make_unique<GpuTimer>();
+			m_ChunkTimer = std::make_unique<GpuTimer>();
 		}
 
 		virtual void Update() override
 		{
+			FC_PROFILE_SCOPE("Game update");
+
 			Sandbox* game = GetStateManager()->GetUserPtr<Sandbox>();
 
 			s_DebugData.playerPos = m_Player.m_Transform.m_Pos;
 			s_DebugData.Draw();
+			m_ProfilerWindow.Draw(s_DebugData.showProfiler);
+
+			// the frustum and the view radius decide which chunks stream in and so what the player collides with
+			// recordings pin both, a resized window or a moved slider would otherwise look like a divergence
+			if (m_Recording)
+				s_DebugData.viewRadius = m_Recording->m_ViewRadius;
 
-			m_Player.Update(game->m_Window.GetHandle(), game->GetDeltaTime(), game->m_MouseDelta, m_World);
+			if (m_Flythrough && !m_Replaying)
+				m_Flythrough->Step(m_Player.m_Transform, m_Player.m_TransformExtra);
+			else
+				UpdatePlayer(*game);
 
 			auto [w, h] = game->m_Window.GetSize();
-			m_Camera.m_Aspect = game->m_Window.GetAspect();
+			m_Camera.m_Aspect = m_Recording ? m_Recording->m_Aspect : game->m_Window.GetAspect();
 
 			glViewport(0, 0, w, h);
+			m_ClearTimer->Begin();
 			glClearColor(0.7f, 0.8f, 0.9f, 1.0f);
 			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			m_ClearTimer->End();
 
 			if (s_DebugData.enableWireframe) glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
@@ -224,22 +318,174 @@ namespace FoxoCraft
 			glm::mat4 viewMatrix = glm::inverse(t.ToMatrix() * m_Player.m_TransformExtra.ToMatrix());
 
 			game->m_Program.UniformMat4f("u_View", viewMatrix);
-			game->m_Program.UniformMat4f("u_Model", glm::mat4(1.0f));
 			game->m_Program.Uniform1i("u_Albedo", 0);
 
-			m_World.Render(projectionMatrix * viewMatrix, s_DebugData);
+			game->m_Program.UniformMat4f("u_Model", glm::mat4(1.0f));
+			m_World->Update(m_Player.m_Transform.m_Pos, projectionMatrix * viewMatrix, s_DebugData);
+
+			m_ChunkTimer->Begin();
+			m_Renderer->Render(*m_World, projectionMatrix * viewMatrix, s_DebugData);
+			m_ChunkTimer->End();
+
+			s_DebugData.gpuClear = m_ClearTimer->GetStats();
+			s_DebugData.gpuChunks = m_ChunkTimer->GetStats();
+			s_DebugData.gpuImGui = game->m_ImGuiTimer->GetStats();
 
 			if (s_DebugData.enableWireframe) glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+			if (m_ReplayDiverged)
+				FinishReplay(*game);
+			else if (m_Flythrough)
+				UpdateBenchmark(*game);
+			else if (m_Replaying && m_ReplayFrame == m_Recording->m_Frames.size())
+				FinishReplay(*game);
 		}
 
 		virtual void Destroy() override
 		{
+			Shutdown();
+		}
+
+		// Writes the recording and the world and frees the gl resources, only the first call does anything
+		// Sandbox::Destroy calls it before the context goes away, whether or not the state manager destroyed the state yet
+		void Shutdown()
+		{
+			if (!m_World) return;
+
+			Sandbox* game = GetStateManager()->GetUserPtr<Sandbox>();
+			game->m_Game = nullptr;
+
+			if (m_Recording && !m_Replaying)
+			{
+				const std::filesystem::path& path = game->m_Options.m_Record;
+				if (m_Recording->Save(path))
+					FC_LOG_INFO("Recorded {} frames to {}", m_Recording->m_Frames.size(), path.u8string());
+			}
+
+			// the renderer frees its buffers while the context is alive
+			m_Renderer.reset();
+			m_ClearTimer.reset();
+			m_ChunkTimer.reset();
+
+			// every modified chunk is queued and the saver drained before the world goes away
+			if (m_World->m_Saver)
+			{
+				size_t pending = m_World->m_Saver->GetQueueDepth();
+				m_World->Save();
+				FC_LOG_INFO("Flushed the world on exit, {} chunks were pending, {} written this session", pending, m_World->m_Storage->m_ChunksSaved.load());
+			}
+
+			m_World.reset();
 		}
 	private:
+		bool LoadReplay(const std::filesystem::path& path)
+		{
+			m_Recording = std::make_unique<InputRecording>();
+
+			if (!m_Recording->Load(path) || m_Recording->m_Frames.empty())
+			{
+				FC_LOG_ERROR("Not replaying {}", path.u8string());
+				m_Recording.reset();
+				return false;
+			}
+
+			FC_LOG_INFO("Replaying {} frames from {}", m_Recording->m_Frames.size(), path.u8string());
+			m_Replaying = true;
+			return true;
+		}
+
+		// Live input or the next replayed frame, with the player position checked against or added to the recording
+		void UpdatePlayer(Sandbox& game)
+		{
+			// frames only count once the ground under the player exists, so collision sees the same blocks no matter how fast chunks generate
+			if (m_Recording)
+			{
+				glm::ivec3 cs = glm::floor(m_Player.m_Transform.m_Pos / static_cast<float>(s_ChunkSize));
+				if (!m_World->GetChunk(cs) || !m_World->GetChunk(cs - glm::ivec3(0, 1, 0))) return;
+			}
+
+			if (!m_Replaying)
+			{
+				InputFrame input = InputFrame::Poll(game.m_Window.GetHandle(), game.GetDeltaTime(), game.m_MouseDelta, MouseLock::IsLocked());
+				m_Player.Update(input, *m_World);
+
+				if (m_Recording) m_Recording->Add(input, m_Player.m_Transform.m_Pos);
+				return;
+			}
+
+			if (m_ReplayFrame == m_Recording->m_Frames.size()) return;
+
+			m_Player.Update(m_Recording->m_Frames[m_ReplayFrame], *m_World);
+
+			float distance = glm::distance(m_Player.m_Transform.m_Pos, m_Recording->m_Positions[m_ReplayFrame]);
+			if (distance > 0.001f)
+			{
+				FC_LOG_ERROR("Replay diverged from the recording at frame {} by {:.3f} blocks", m_ReplayFrame, distance);
+				m_ReplayDiverged = true;
+			}
+
+			++m_ReplayFrame;
+		}
+
+		// A diverged replay stops right away, without benchmark results, and the process exits with 1
+		void FinishReplay(Sandbox& game)
+		{
+			if (m_ReplayDiverged)
+			{
+				game.m_ExitCode = 1;
+				m_Flythrough.reset();
+			}
+			else
+			{
+				FC_LOG_INFO("Replay matched the recording");
+			}
+
+			m_ReplayDiverged = false;
+			m_Recording.reset();
+			m_Replaying = false;
+			game.Stop();
+		}
+
+		void UpdateBenchmark(Sandbox& game)
+		{
+			m_Flythrough->Record(s_DebugData);
+
+			bool done = m_Replaying ? m_ReplayFrame == m_Recording->m_Frames.size() : m_Flythrough->IsDone();
+			if (!done) return;
+
+			FC_LOG_INFO("Benchmark: {} frames, frame time p50 {:.2f} ms, p99 {:.2f} ms, max {:.2f} ms, {} chunks generated, {} meshed",
+				m_Flythrough->GetFrameCount(), m_Flythrough->GetFrameTime(0.5), m_Flythrough->GetFrameTime(0.99), m_Flythrough->GetFrameTime(1.0),
+				m_World->m_ChunksGenerated, m_World->m_ChunksMeshed);
+
+			const char* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+			if (m_Flythrough->WriteCsv(game.m_Options.m_BenchmarkCsv, m_Seed, *m_World, renderer ? renderer : ""))
+				FC_LOG_INFO("Wrote {}", game.m_Options.m_BenchmarkCsv.u8string());
+
+			m_Flythrough.reset();
+
+			if (m_Replaying)
+				FinishReplay(game);
+			else
+				game.Stop();
+		}
+
 		Camera m_Camera;
 		Player m_Player;
-		World m_World = World(0);
+		int64_t m_Seed = 0;
+		std::unique_ptr<Flythrough> m_Flythrough;
+
+		// input being recorded, or played back while m_Replaying is set
+		std::unique_ptr<InputRecording> m_Recording;
+		bool m_Replaying = false;
+		bool m_ReplayDiverged = false;
+		size_t m_ReplayFrame = 0;
+
+		std::unique_ptr<World> m_World;
+		std::unique_ptr<ChunkRenderer> m_Renderer;
+		std::unique_ptr<GpuTimer> m_ClearTimer;
+		std::unique_ptr<GpuTimer> m_ChunkTimer;
 		DebugData s_DebugData;
+		ProfilerWindow m_ProfilerWindow;
 	};
 
 	class MenuState final : public FoxoCommons::State
@@ -275,8 +521,15 @@ namespace FoxoCraft
 		}
 	};
 
+	Sandbox::Sandbox(const LaunchOptions& options)
+		: m_Options(options)
+	{
+	}
+
 	void Sandbox::Init()
 	{
+		Profiler::SetThreadName("Main");
+
 		m_Window = FoxoCommons::Window(1280, 720, "FoxoCraft", []()
 		{
 			glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
@@ -353,12 +606,24 @@ namespace FoxoCraft
 		glFrontFace(GL_CCW);
 		glEnable(GL_DEPTH_TEST);
 
+		m_ImGuiTimer = std::make_unique<GpuTimer>();
+
 		m_StateManger.SetUserPtr(this);
-		m_StateManger.SetState<MenuState>();
+
+		// frame times are the point of benchmarks and replays, never wait for vsync
+		if (m_Options.m_Benchmark || !m_Options.m_Replay.empty())
+			glfwSwapInterval(0);
+
+		if (m_Options.m_Benchmark || !m_Options.m_Replay.empty() || !m_Options.m_Record.empty())
+			m_StateManger.SetState<GameState>();
+		else
+			m_StateManger.SetState<MenuState>();
 	}
 
 	void Sandbox::Update()
 	{
+		Profiler::BeginFrame();
+
 		m_MouseLast = m_MouseCurrent;
 		glfwPollEvents();
 		m_MouseDelta = m_MouseCurrent - m_MouseLast;
@@ -376,14 +641,27 @@ namespace FoxoCraft
 		
 		m_StateManger.Update();
 
-		ImGui::Render();
-		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+		{
+			FC_PROFILE_SCOPE("ImGui render");
+			ImGui::Render();
+
+			m_ImGuiTimer->Begin();
+			ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+			m_ImGuiTimer->End();
+		}
 
+		FC_PROFILE_SCOPE("Swap buffers");
 		m_Window.SwapBuffers();
 	}
 
 	void Sandbox::Destroy()
 	{
+		// the game saves its world and frees its buffers here, not whenever the state manager gets to it
+		if (m_Game)
+			m_Game->Shutdown();
+
+		m_ImGuiTimer.reset();
+
 		ImGui_ImplOpenGL3_Shutdown();
 		ImGui_ImplGlfw_Shutdown();
 		ImGui::DestroyContext();
@@ -446,7 +724,7 @@ struct Deprecated_Camera
 			FoxoCommons::Transform newTransform;
 			newTransform.Decompose(matrix);
 
-			FoxoCraft::Block* block = world.GetBlockWS(newTransform.m_Pos);
+			FoxoCraft::BlockId block = world.GetBlockWS(newTransform.m_Pos);
 
 			if (!block)
 			{
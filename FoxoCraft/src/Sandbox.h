@@ -11,7 +11,12 @@
 #include <FoxoCommons/Application.h>
 
 #include "Chunk.h"
+#include "ChunkRenderer.h"
 #include "DebugInfo.h"
+#include "Flythrough.h"
+#include "GpuTimer.h"
+#include "InputRecording.h"
+#include "ProfilerWindow.h"
 
 namespace MouseLock
 {
@@ -35,7 +40,7 @@ struct Player
 
 	Player();
 
-	void Update(GLFWwindow* window, double deltaTime, glm::vec2 mouseDelta, FoxoCraft::World& world);
+	void Update(const FoxoCraft::InputFrame& input, FoxoCraft::World& world);
 };
 
 struct Camera final
@@ -53,10 +58,28 @@ struct Camera final
 
 namespace FoxoCraft
 {
+	class GameState;
+
+	// Parsed from the command line by main
+	struct LaunchOptions
+	{
+		// skip the menu and fly a scripted path through a fixed seed, then write the results and quit
+		bool m_Benchmark = false;
+		std::filesystem::path m_BenchmarkCsv = "FoxoCraft/benchmark.csv";
+		size_t m_BenchmarkFrames = 1800;
+
+		// world seed of --benchmark and --record, replays use the seed stored in the recording
+		int64_t m_Seed = 1234;
+
+		// write the input of every frame to m_Record, or play m_Replay back instead of reading input
+		std::filesystem::path m_Record;
+		std::filesystem::path m_Replay;
+	};
+
 	class Sandbox : public FoxoCommons::Application
 	{
 	public:
-		Sandbox() = default;
+		explicit Sandbox(const LaunchOptions& options = LaunchOptions());
 		virtual ~Sandbox() = default;
 
 		virtual void Init() override;
@@ -64,6 +87,8 @@ namespace FoxoCraft
 		virtual void Destroy() override;
 		virtual double GetTime() override;
 	public:
+		LaunchOptions m_Options;
+
 		FoxoCommons::Window m_Window;
 
 		glm::vec2 m_MouseLast = glm::vec2();
@@ -74,5 +99,14 @@ namespace FoxoCraft
 
 		FoxoCommons::Program m_Program;
 		FoxoCommons::Texture2DArray m_Texture;
+
+		// created once the context exists
+		std::unique_ptr<GpuTimer> m_ImGuiTimer;
+
+		// set while a game is running, shut down by Destroy before ImGui and the context
+		GameState* m_Game = nullptr;
+
+		// returned by main, a replay that diverged from its recording sets it to 1
+		int m_ExitCode = 0;
 	};
 }
\ No newline at end of file
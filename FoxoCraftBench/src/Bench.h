@@ -0,0 +1,47 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace FoxoCraftBench
+{
+	// Wall clock stopwatch used by every benchmark
+	struct Timer
+	{
+		std::chrono::steady_clock::time_point m_Start = std::chrono::steady_clock::now();
+
+		double ElapsedSeconds() const
+		{
+			return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_Start).count();
+		}
+	};
+
+#if defined(_MSC_VER) && !defined(__clang__)
+	// Does nothing, defined in EntryPoint.cpp so the optimizer cannot see through the call
+	void EscapePointer(const void* pointer);
+#endif
+
+	// Keeps the optimizer from discarding benchmark results
+	// The value is handed to an empty asm statement that claims to read it and clobber memory, msvc has no inline asm on x64
+	template<typename T>
+	inline void DoNotOptimize(const T& value)
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		EscapePointer(&value);
+#else
+		asm volatile("" : : "r,m"(value) : "memory");
+#endif
+	}
+
+	// Registers the core blocks with placeholder faces, safe to call from every benchmark
+	void RegisterBenchBlocks();
+
+	// Peak resident memory of the process in bytes
+	size_t GetPeakMemory();
+
+	// Each benchmark returns false when it failed, main then exits non-zero
+	bool RunChunkMapBench();
+	bool RunProfilerBench();
+	bool RunRegionBench();
+	bool RunWorldBench();
+}
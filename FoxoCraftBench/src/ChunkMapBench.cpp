@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "Bench.h"
+#include "ChunkMap.h"
+#include "Log.h"
+
+namespace FoxoCraftBench
+{
+	// The hash World used before ChunkMap, kept here as the baseline
+	struct XorKeyHash
+	{
+		size_t operator()(const glm::ivec3& k) const
+		{
+			return std::hash<int>()(k.x) ^ std::hash<int>()(k.y) ^ std::hash<int>()(k.z);
+		}
+	};
+
+	struct Dummy
+	{
+		int m_Value = 0;
+	};
+
+	// Chunk coordinates shaped like a loaded world, a wide square in x/z that is 7 chunks tall
+	static std::vector<glm::ivec3> MakeKeys(size_t count)
+	{
+		constexpr int height = 7;
+		int side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(count) / height)));
+
+		std::vector<glm::ivec3> keys;
+		keys.reserve(count);
+
+		for (int z = 0; z < side && keys.size() < count; ++z)
+		{
+			for (int y = 0; y < height && keys.size() < count; ++y)
+			{
+				for (int x = 0; x < side && keys.size() < count; ++x)
+					keys.emplace_back(x - side / 2, y - height / 2, z - side / 2);
+			}
+		}
+
+		return keys;
+	}
+
+	template<typename Lookup>
+	static double MeasureLookups(const std::vector<glm::ivec3>& queries, size_t rounds, Lookup lookup)
+	{
+		int sum = 0;
+		Timer timer;
+
+		for (size_t r = 0; r < rounds; ++r)
+		{
+			for (const glm::ivec3& key : queries)
+				sum += lookup(key);
+		}
+
+		double seconds = timer.ElapsedSeconds();
+		DoNotOptimize(sum);
+		return static_cast<double>(queries.size() * rounds) / seconds;
+	}
+
+	static void RunSize(size_t count)
+	{
+		std::vector<glm::ivec3> keys = MakeKeys(count);
+
+		std::unordered_map<glm::ivec3, std::shared_ptr<Dummy>, XorKeyHash> baseline;
+		FoxoCraft::ChunkMap<std::shared_ptr<Dummy>> chunkMap;
+
+		Timer insertBaseline;
+		for (const glm::ivec3& key : keys) baseline[key] = std::make_shared<Dummy>();
+		double baselineInsert = insertBaseline.ElapsedSeconds();
+
+		Timer insertChunkMap;
+		for (const glm::ivec3& key : keys) chunkMap.Insert(key, std::make_shared<Dummy>());
+		double chunkMapInsert = insertChunkMap.ElapsedSeconds();
+
+		// random hits plus an equal share of misses just outside the loaded area
+		std::mt19937 random(1234);
+		std::vector<glm::ivec3> queries;
+		queries.reserve(200000);
+
+		for (size_t i = 0; i < 100000; ++i)
+		{
+			glm::ivec3 key = keys[random() % keys.size()];
+			queries.push_back(key);
+			queries.push_back(key + glm::ivec3(0, 7, 0));
+		}
+
+		std::shuffle(queries.begin(), queries.end(), random);
+
+		// the baseline degrades badly with size, a single pass keeps the run short
+		size_t rounds = count <= 10000 ? 10 : 1;
+
+		double baselineRate = MeasureLookups(queries, rounds, [&](glm::ivec3 key)
+		{
+			auto result = baseline.find(key);
+			return result != baseline.end() ? result->second->m_Value + 1 : 0;
+		});
+
+		double chunkMapRate = MeasureLookups(queries, rounds, [&](glm::ivec3 key)
+		{
+			std::shared_ptr<Dummy>* result = chunkMap.Find(key);
+			return result ? (*result)->m_Value + 1 : 0;
+		});
+
+		size_t worstBucket = 0;
+		for (size_t i = 0; i < baseline.bucket_count(); ++i)
+			worstBucket = std::max(worstBucket, baseline.bucket_size(i));
+
+		FC_LOG_INFO("{} chunks", keys.size());
+		FC_LOG_INFO("  unordered_map + xor hash: {:.2f} M lookups/s, insert {:.2f} ms, largest bucket {}", baselineRate / 1e6, baselineInsert * 1e3, worstBucket);
+		FC_LOG_INFO("  ChunkMap:                 {:.2f} M lookups/s, insert {:.2f} ms", chunkMapRate / 1e6, chunkMapInsert * 1e3);
+		FC_LOG_INFO("  speedup: {:.1f}x", chunkMapRate / baselineRate);
+	}
+
+	bool RunChunkMapBench()
+	{
+		RunSize(10000);
+		RunSize(100000);
+		return true;
+	}
+}
@@ -0,0 +1,117 @@
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+	#include <psapi.h>
+#else
+	#include <sys/resource.h>
+#endif
+
+#include "Bench.h"
+#include "Block.h"
+#include "Log.h"
+
+void FoxoCraftBench::RegisterBenchBlocks()
+{
+	static bool s_Registered = false;
+	if (s_Registered) return;
+	s_Registered = true;
+
+	FoxoCraft::RegisterBlockFace("bench.top", FoxoCraft::BlockFace(0));
+	FoxoCraft::RegisterBlockFace("bench.side", FoxoCraft::BlockFace(1));
+	FoxoCraft::RegisterBlockFace("bench.bottom", FoxoCraft::BlockFace(2));
+
+	for (const char* name : { "core.grass", "core.dirt", "core.wood", "core.stone" })
+		FoxoCraft::RegisterBlock(name, FoxoCraft::Block(FoxoCraft::GetBlockFace("bench.top"), FoxoCraft::GetBlockFace("bench.side"), FoxoCraft::GetBlockFace("bench.bottom")));
+
+	FoxoCraft::LockModify();
+}
+
+size_t FoxoCraftBench::GetPeakMemory()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+	return counters.PeakWorkingSetSize;
+#else
+	rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+
+	// bytes on macOS, kilobytes everywhere else
+#ifdef __APPLE__
+	return static_cast<size_t>(usage.ru_maxrss);
+#else
+	return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+#if defined(_MSC_VER) && !defined(__clang__)
+void FoxoCraftBench::EscapePointer(const void*)
+{
+}
+#endif
+
+struct BenchEntry
+{
+	const char* m_Name;
+	bool (*m_Run)();
+};
+
+static constexpr BenchEntry s_Benches[] =
+{
+	{ "chunkmap", FoxoCraftBench::RunChunkMapBench },
+	{ "profiler", FoxoCraftBench::RunProfilerBench },
+	{ "region", FoxoCraftBench::RunRegionBench },
+	{ "world", FoxoCraftBench::RunWorldBench }
+};
+
+// Usage: FoxoCraftBench [name...], runs every benchmark when no names are given
+// Exits with 1 when a name is unknown or a benchmark failed
+int main(int argc, char** argv)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		bool known = false;
+
+		for (const BenchEntry& bench : s_Benches)
+		{
+			if (std::strcmp(argv[i], bench.m_Name) == 0)
+				known = true;
+		}
+
+		if (!known)
+		{
+			FC_LOG_ERROR("Unknown benchmark {}", argv[i]);
+			return 1;
+		}
+	}
+
+	bool passed = true;
+
+	for (const BenchEntry& bench : s_Benches)
+	{
+		bool selected = argc <= 1;
+
+		for (int i = 1; i < argc; ++i)
+		{
+			if (std::strcmp(argv[i], bench.m_Name) == 0)
+				selected = true;
+		}
+
+		if (!selected) continue;
+
+		FC_LOG_INFO("Running {}", bench.m_Name);
+
+		if (!bench.m_Run())
+		{
+			FC_LOG_ERROR("{} failed", bench.m_Name);
+			passed = false;
+		}
+	}
+
+	return passed ? 0 : 1;
+}
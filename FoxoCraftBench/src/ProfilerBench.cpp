@@ -0,0 +1,74 @@
+#include <filesystem>
+#include <vector>
+
+#include "Bench.h"
+#include "JobSystem.h"
+#include "Log.h"
+
+namespace FoxoCraftBench
+{
+	static constexpr size_t s_Zones = 10000000;
+
+	bool RunProfilerBench()
+	{
+		FoxoCraft::Profiler::SetThreadName("Bench");
+
+		{
+			Timer timer;
+
+			for (size_t i = 0; i < s_Zones; ++i)
+			{
+				FC_PROFILE_SCOPE("Empty zone");
+			}
+
+			double seconds = timer.ElapsedSeconds();
+			FC_LOG_INFO("  empty zone: {:.1f} ns", seconds * 1e9 / s_Zones);
+		}
+
+		{
+			Timer timer;
+
+			for (size_t i = 0; i < s_Zones / 2; ++i)
+			{
+				FC_PROFILE_SCOPE("Outer zone");
+				FC_PROFILE_SCOPE("Inner zone");
+			}
+
+			double seconds = timer.ElapsedSeconds();
+			FC_LOG_INFO("  nested zone: {:.1f} ns", seconds * 1e9 / s_Zones);
+		}
+
+		// workers fill their rings while the main thread reads them, the way the flame view does every frame
+		FoxoCraft::JobSystem jobs;
+		std::vector<FoxoCraft::Profiler::Event> events;
+		size_t collected = 0;
+
+		for (size_t i = 0; i < jobs.GetThreadCount(); ++i)
+		{
+			jobs.Submit([]()
+			{
+				for (size_t i = 0; i < s_Zones / 10; ++i)
+				{
+					FC_PROFILE_SCOPE("Worker zone");
+				}
+			});
+		}
+
+		while (jobs.GetPendingCount() != 0)
+		{
+			events.clear();
+			FoxoCraft::Profiler::Collect(0, UINT64_MAX, events);
+			collected += events.size();
+		}
+
+		jobs.Wait();
+		FC_LOG_INFO("  collected {} zones while recording", collected);
+
+		std::filesystem::path path = std::filesystem::temp_directory_path() / "FoxoCraftBench-trace.json";
+		if (!FoxoCraft::Profiler::ExportChromeTrace(path)) return false;
+
+		FC_LOG_INFO("  trace is {:.1f} KiB", std::filesystem::file_size(path) / 1024.0);
+		std::filesystem::remove(path);
+		return true;
+	}
+}
@@ -0,0 +1,142 @@
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "Bench.h"
+#include "Block.h"
+#include "BlockStorage.h"
+#include "JobSystem.h"
+#include "Log.h"
+#include "WorldStorage.h"
+
+namespace FoxoCraftBench
+{
+	static constexpr int s_ChunkSize = 32;
+	static constexpr size_t s_ChunkSize3 = s_ChunkSize * s_ChunkSize * s_ChunkSize;
+
+	// Rolling hills of grass, dirt and stone with scattered wood, close enough to generated terrain to compress similarly
+	static FoxoCraft::BlockStorage MakeTerrain(glm::ivec3 cs, std::mt19937& random)
+	{
+		FoxoCraft::BlockId grass = FoxoCraft::GetBlockId("core.grass");
+		FoxoCraft::BlockId dirt = FoxoCraft::GetBlockId("core.dirt");
+		FoxoCraft::BlockId stone = FoxoCraft::GetBlockId("core.stone");
+		FoxoCraft::BlockId wood = FoxoCraft::GetBlockId("core.wood");
+
+		FoxoCraft::BlockStorage storage(s_ChunkSize3);
+
+		for (int z = 0; z < s_ChunkSize; ++z)
+		{
+			for (int x = 0; x < s_ChunkSize; ++x)
+			{
+				glm::ivec3 ws = cs * s_ChunkSize + glm::ivec3(x, 0, z);
+				int height = static_cast<int>(40.0 + 12.0 * std::sin(ws.x * 0.05) + 9.0 * std::cos(ws.z * 0.07));
+
+				for (int y = 0; y < s_ChunkSize; ++y)
+				{
+					int wy = cs.y * s_ChunkSize + y;
+
+					FoxoCraft::BlockId block = FoxoCraft::s_AirBlock;
+					if (wy < height - 3) block = stone;
+					else if (wy < height - 1) block = dirt;
+					else if (wy < height) block = grass;
+					if (block && random() % 200 == 0) block = wood;
+
+					if (block) storage.Set((z * s_ChunkSize + y) * s_ChunkSize + x, block);
+				}
+			}
+		}
+
+		storage.Optimize();
+		return storage;
+	}
+
+	// Loads every chunk back, returns false without a rate when any of them failed so a broken read path cannot look fast
+	static bool LoadAll(FoxoCraft::WorldStorage& storage, const std::vector<glm::ivec3>& chunks, size_t threads)
+	{
+		FoxoCraft::JobSystem jobs(threads);
+		size_t batch = (chunks.size() + jobs.GetThreadCount() - 1) / jobs.GetThreadCount();
+		std::atomic<size_t> failed = 0;
+
+		Timer timer;
+
+		for (size_t begin = 0; begin < chunks.size(); begin += batch)
+		{
+			jobs.Submit([&storage, &chunks, &failed, begin, end = std::min(begin + batch, chunks.size())]()
+			{
+				FoxoCraft::BlockStorage loaded(s_ChunkSize3);
+
+				for (size_t i = begin; i < end; ++i)
+				{
+					if (!storage.LoadChunk(chunks[i], loaded))
+					{
+						++failed;
+						continue;
+					}
+
+					DoNotOptimize(loaded.Get(0));
+				}
+			});
+		}
+
+		jobs.Wait();
+		double seconds = timer.ElapsedSeconds();
+
+		if (failed)
+		{
+			FC_LOG_ERROR("  {} threads: {} of {} chunks failed to load", jobs.GetThreadCount(), failed.load(), chunks.size());
+			return false;
+		}
+
+		FC_LOG_INFO("  {} threads: {:.0f} chunks/s", jobs.GetThreadCount(), chunks.size() / seconds);
+		return true;
+	}
+
+	bool RunRegionBench()
+	{
+		RegisterBenchBlocks();
+
+		std::filesystem::path directory = std::filesystem::temp_directory_path() / "FoxoCraftBench-region";
+		std::filesystem::remove_all(directory);
+
+		// 32x32 columns of 6 chunks, spread over several region files
+		std::vector<glm::ivec3> chunks;
+		for (int z = -16; z < 16; ++z)
+		{
+			for (int y = -2; y < 4; ++y)
+			{
+				for (int x = -16; x < 16; ++x)
+					chunks.emplace_back(x, y, z);
+			}
+		}
+
+		{
+			auto storage = std::make_unique<FoxoCraft::WorldStorage>(directory);
+			int64_t seed = 0;
+			storage->LoadInfo(seed);
+			storage->SaveInfo(seed);
+
+			std::mt19937 random(1234);
+			Timer timer;
+
+			for (glm::ivec3 cs : chunks)
+				storage->SaveChunk(cs, MakeTerrain(cs, random));
+
+			double seconds = timer.ElapsedSeconds();
+			FC_LOG_INFO("Wrote {} chunks, {:.1f} KiB compressed, {:.2f} s including terrain", chunks.size(), storage->m_BytesWritten / 1024.0, seconds);
+		}
+
+		// a fresh storage so nothing is cached, the page cache is still warm from writing
+		FoxoCraft::WorldStorage storage(directory);
+		int64_t seed = 0;
+		storage.LoadInfo(seed);
+
+		FC_LOG_INFO("Loading {} chunks", chunks.size());
+		bool loaded = LoadAll(storage, chunks, 1) && LoadAll(storage, chunks, 0);
+
+		std::filesystem::remove_all(directory);
+		return loaded;
+	}
+}
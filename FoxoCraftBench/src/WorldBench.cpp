@@ -0,0 +1,275 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "Bench.h"
+#include "Chunk.h"
+#include "ChunkMesher.h"
+#include "Log.h"
+
+namespace FoxoCraftBench
+{
+	// fixed so runs on different machines and commits generate the same terrain
+	static constexpr int64_t s_Seed = 1234;
+
+	// 16x16 columns of 8 chunks around the surface
+	static constexpr int s_Radius = 8;
+	static constexpr int s_BottomChunk = -4;
+	static constexpr int s_TopChunk = 4;
+
+	static constexpr int s_Size = static_cast<int>(FoxoCraft::s_ChunkSize);
+
+	// a pass over the world takes tens of milliseconds, far too short to time just once
+	static constexpr size_t s_MinPasses = 5;
+	static constexpr double s_MinSeconds = 1.0;
+
+	// Runs pass once untimed to warm caches and buffers, then until it has run s_MinPasses times and for s_MinSeconds
+	// Returns the fastest pass in seconds, the one least disturbed by the rest of the machine
+	template<typename Pass>
+	static double TimeFastest(Pass&& pass)
+	{
+		pass();
+
+		double fastest = std::numeric_limits<double>::max();
+		size_t passes = 0;
+		Timer total;
+
+		while (passes < s_MinPasses || total.ElapsedSeconds() < s_MinSeconds)
+		{
+			Timer timer;
+			pass();
+			fastest = std::min(fastest, timer.ElapsedSeconds());
+			++passes;
+		}
+
+		return fastest;
+	}
+
+	// Block at a position inside the chunk or one step past one of its sides, unloaded neighbors read as air
+	static FoxoCraft::BlockId GetReferenceBlock(const FoxoCraft::ChunkSnapshot& snapshot, glm::ivec3 ls)
+	{
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			if (ls[axis] >= 0 && ls[axis] < s_Size) continue;
+
+			const std::shared_ptr<const FoxoCraft::BlockStorage>& neighbor = snapshot.m_Neighbors[axis * 2 + (ls[axis] < 0 ? 0 : 1)];
+			if (!neighbor) return FoxoCraft::s_AirBlock;
+
+			ls[axis] += ls[axis] < 0 ? s_Size : -s_Size;
+			return neighbor->Get(FoxoCraft::Chunk::IndexLS(ls));
+		}
+
+		return snapshot.m_Data->Get(FoxoCraft::Chunk::IndexLS(ls));
+	}
+
+	// The naive mesher as it was before the occupancy bitmasks, one Get per block and per neighbor of every solid block
+	// Uniform solid chunks only check their border like it did, the baseline BuildMeshV2 is timed and checked against
+	static void BuildReferenceMesh(const FoxoCraft::ChunkSnapshot& snapshot, FoxoCraft::MeshScratch& scratch, std::vector<uint32_t>& vertices)
+	{
+		const FoxoCraft::BlockStorage& data = *snapshot.m_Data;
+		int count = 0;
+
+		scratch.m_Size = 0;
+
+		if (data.IsUniform())
+		{
+			FoxoCraft::BlockId block = data.Get(0);
+
+			for (size_t i = 0; block && i < 6; ++i)
+			{
+				glm::ivec3 dir = glm::ivec3(FoxoCraft::s_FaceDirections[i]);
+				const FoxoCraft::BlockStorage* neighbor = snapshot.m_Neighbors[i].get();
+
+				// a uniform solid neighbor hides this whole side
+				if (neighbor && neighbor->IsUniform() && neighbor->Get(0)) continue;
+
+				bool exposed = !neighbor || neighbor->IsUniform();
+
+				int axis = dir.x != 0 ? 0 : (dir.y != 0 ? 1 : 2);
+				int u = (axis + 1) % 3;
+				int v = (axis + 2) % 3;
+
+				glm::ivec3 ls;
+				ls[axis] = dir[axis] > 0 ? s_Size - 1 : 0;
+
+				for (ls[v] = 0; ls[v] < s_Size; ++ls[v])
+				{
+					for (ls[u] = 0; ls[u] < s_Size; ++ls[u])
+					{
+						if (exposed || !GetReferenceBlock(snapshot, ls + dir))
+							FoxoCraft::Faces::AppendQuad(scratch, i, ls, glm::ivec3(1, 1, 1), FoxoCraft::GetBlockInfo(block).m_Textures[FoxoCraft::s_FaceDirections[i].w], count);
+					}
+				}
+			}
+		}
+		else
+		{
+			glm::ivec3 ls;
+
+			for (ls.z = 0; ls.z < s_Size; ++ls.z)
+			{
+				for (ls.y = 0; ls.y < s_Size; ++ls.y)
+				{
+					for (ls.x = 0; ls.x < s_Size; ++ls.x)
+					{
+						FoxoCraft::BlockId block = data.Get(FoxoCraft::Chunk::IndexLS(ls));
+						if (!block) continue;
+
+						const FoxoCraft::BlockInfo& info = FoxoCraft::GetBlockInfo(block);
+
+						for (size_t i = 0; i < 6; ++i)
+						{
+							if (!GetReferenceBlock(snapshot, ls + glm::ivec3(FoxoCraft::s_FaceDirections[i])))
+								FoxoCraft::Faces::AppendQuad(scratch, i, ls, glm::ivec3(1, 1, 1), info.m_Textures[FoxoCraft::s_FaceDirections[i].w], count);
+						}
+					}
+				}
+			}
+		}
+
+		vertices.assign(scratch.m_Data.get(), scratch.m_Data.get() + scratch.m_Size);
+	}
+
+	// Quads of a mesh in a fixed order, the meshers may emit the same quads in a different order
+	static std::vector<std::array<uint32_t, FoxoCraft::s_QuadWords>> SortQuads(const std::vector<uint32_t>& vertices)
+	{
+		std::vector<std::array<uint32_t, FoxoCraft::s_QuadWords>> quads(vertices.size() / FoxoCraft::s_QuadWords);
+		if (!quads.empty()) std::memcpy(quads.data(), vertices.data(), quads.size() * sizeof(quads[0]));
+
+		std::sort(quads.begin(), quads.end());
+		return quads;
+	}
+
+	// Times the reference mesher over every chunk, then checks that BuildMeshV2 produces the same quads for each of them
+	// Returns chunks/s, or 0 when a mesh differs
+	static double MeshReference(FoxoCraft::World& world)
+	{
+		FoxoCraft::MeshScratch scratch;
+		std::vector<uint32_t> vertices;
+		size_t count = 0;
+
+		double seconds = TimeFastest([&]()
+		{
+			count = 0;
+
+			for (auto& [k, v] : world.m_Chunks)
+			{
+				BuildReferenceMesh(v->Snapshot(), scratch, vertices);
+				count += vertices.size();
+				DoNotOptimize(vertices.data());
+			}
+		});
+
+		size_t chunks = world.m_Chunks.Size();
+		double rate = chunks / seconds;
+
+		FC_LOG_INFO("  reference: {:.0f} chunks/s, {:.0f} vertices/chunk", rate, static_cast<double>(count / 2) / chunks);
+
+		size_t mismatched = 0;
+
+		for (auto& [k, v] : world.m_Chunks)
+		{
+			FoxoCraft::ChunkSnapshot snapshot = v->Snapshot();
+			BuildReferenceMesh(snapshot, scratch, vertices);
+
+			if (SortQuads(vertices) != SortQuads(FoxoCraft::BuildMeshV2(snapshot, false).m_Vertices))
+				++mismatched;
+		}
+
+		if (mismatched)
+		{
+			FC_LOG_ERROR("  {} of {} naive meshes differ from the reference", mismatched, chunks);
+			return 0.0;
+		}
+
+		FC_LOG_INFO("  naive meshes match the reference quad for quad");
+		return rate;
+	}
+
+	// Recycles buffer and keeps each chunk's vertex count like the world does, so later passes show steady state allocations
+	// Returns chunks/s of the fastest pass
+	static double MeshAll(FoxoCraft::World& world, bool greedy, std::vector<uint32_t>& buffer)
+	{
+		size_t vertices = 0;
+		std::vector<size_t> allocations;
+
+		double seconds = TimeFastest([&]()
+		{
+			vertices = 0;
+			allocations.push_back(0);
+
+			for (auto& [k, v] : world.m_Chunks)
+			{
+				FoxoCraft::ChunkMesh mesh = FoxoCraft::BuildMeshV2(v->Snapshot(), greedy, std::move(buffer));
+				vertices += mesh.m_Count;
+				allocations.back() += mesh.m_Allocations;
+				DoNotOptimize(mesh.m_Vertices.data());
+
+				v->m_VertexCount = mesh.m_Count;
+				buffer = std::move(mesh.m_Vertices);
+			}
+		});
+
+		size_t count = world.m_Chunks.Size();
+
+		FC_LOG_INFO("  {}: {:.0f} chunks/s, {:.0f} vertices/chunk, {} allocations in the first pass, {} in the last", greedy ? "greedy" : "naive", count / seconds, static_cast<double>(vertices) / count, allocations.front(), allocations.back());
+		return count / seconds;
+	}
+
+	bool RunWorldBench()
+	{
+		RegisterBenchBlocks();
+
+		// no storage and nothing rendered, only the CPU side of the world is used
+		FoxoCraft::World world(s_Seed);
+
+		std::vector<glm::ivec3> chunks;
+		for (int z = -s_Radius; z < s_Radius; ++z)
+		{
+			for (int y = s_BottomChunk; y < s_TopChunk; ++y)
+			{
+				for (int x = -s_Radius; x < s_Radius; ++x)
+					chunks.emplace_back(x, y, z);
+			}
+		}
+
+		FC_LOG_INFO("Generating {} chunks with seed {} on one thread", chunks.size(), s_Seed);
+
+		{
+			Timer timer;
+
+			for (glm::ivec3 cs : chunks)
+			{
+				auto chunk = std::make_shared<FoxoCraft::Chunk>(cs, &world);
+				chunk->Generate();
+				world.InsertChunk(std::move(chunk));
+			}
+
+			double seconds = timer.ElapsedSeconds();
+			FC_LOG_INFO("  generate: {:.0f} chunks/s, {} heightmap misses", chunks.size() / seconds, world.m_Generator.m_HeightmapMisses.load());
+		}
+
+		size_t memory = 0;
+		for (auto& [k, v] : world.m_Chunks)
+			memory += v->GetMemoryUsage();
+
+		FC_LOG_INFO("  storage: {:.1f} KiB/chunk", memory / 1024.0 / chunks.size());
+
+		// both meshers are warmed and timed the same way, so the speedup compares their fastest passes
+		double reference = MeshReference(world);
+
+		std::vector<uint32_t> buffer;
+		double naive = MeshAll(world, false, buffer);
+		MeshAll(world, true, buffer);
+
+		if (reference == 0.0) return false;
+
+		FC_LOG_INFO("  naive speedup over the reference: {:.1f}x", naive / reference);
+
+		FC_LOG_INFO("  peak RSS: {:.1f} MiB", GetPeakMemory() / (1024.0 * 1024.0));
+		return true;
+	}
+}
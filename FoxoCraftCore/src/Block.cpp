@@ -0,0 +1,123 @@
+#include "Block.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include <FoxoCommons/debug-trap.h>
+
+#include "Log.h"
+
+namespace FoxoCraft
+{
+	BlockFace::BlockFace(size_t index)
+		: m_TextureIndex(index)
+	{
+	}
+
+	Block::Block(BlockFace* top, BlockFace* side, BlockFace* bottom)
+		: m_Top(top), m_Side(side), m_Bottom(bottom)
+	{
+	}
+
+	static std::unordered_map<std::string, BlockFace> s_BlockFaces;
+	static std::unordered_map<std::string, Block> s_Blocks;
+	static bool s_LockModify = false;
+
+	static std::unordered_map<std::string, BlockId> s_BlockIds;
+	static std::vector<BlockInfo> s_BlockTable = { BlockInfo{ "core.air" } };
+
+	BlockFace* GetBlockFace(const std::string& id)
+	{
+		auto result = s_BlockFaces.find(id);
+
+		if (result != s_BlockFaces.end())
+			return &result->second;
+
+		return nullptr;
+	}
+
+	void RegisterBlockFace(const std::string& id, const BlockFace& face)
+	{
+		if (s_LockModify)
+		{
+			FC_LOG_ERROR("Registers have been locked, cannot modify further");
+			psnip_trap();
+			return;
+		}
+
+		s_BlockFaces[id] = face;
+	}
+
+	void RegisterBlock(const std::string& id, const Block& block)
+	{
+		if (s_LockModify)
+		{
+			FC_LOG_ERROR("Registers have been locked, cannot modify further");
+			psnip_trap();
+			return;
+		}
+
+		s_Blocks[id] = block;
+	}
+
+	static uint32_t GetFaceTexture(const std::string& id, BlockFace* face)
+	{
+		if (!face)
+		{
+			FC_LOG_ERROR("Block {} is missing a face", id);
+			return 0;
+		}
+
+		return static_cast<uint32_t>(face->m_TextureIndex);
+	}
+
+	void LockModify()
+	{
+		if (s_LockModify) return;
+		s_LockModify = true;
+
+		std::vector<std::string> names;
+		names.reserve(s_Blocks.size());
+
+		for (auto& [k, v] : s_Blocks)
+			names.push_back(k);
+
+		std::sort(names.begin(), names.end());
+
+		for (const auto& name : names)
+		{
+			const Block& block = s_Blocks[name];
+
+			BlockInfo info;
+			info.m_Name = name;
+			info.m_Textures[0] = GetFaceTexture(name, block.m_Top);
+			info.m_Textures[1] = GetFaceTexture(name, block.m_Side);
+			info.m_Textures[2] = GetFaceTexture(name, block.m_Bottom);
+
+			s_BlockIds[name] = static_cast<BlockId>(s_BlockTable.size());
+			s_BlockTable.push_back(info);
+		}
+	}
+
+	BlockId GetBlockId(const std::string& id)
+	{
+		auto result = s_BlockIds.find(id);
+
+		if (result != s_BlockIds.end())
+			return result->second;
+
+		FC_LOG_WARN("Unknown block {}", id);
+		return s_AirBlock;
+	}
+
+	const BlockInfo& GetBlockInfo(BlockId id)
+	{
+		return s_BlockTable[id];
+	}
+
+	size_t GetBlockCount()
+	{
+		return s_BlockTable.size();
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace FoxoCraft
+{
+	// Dense numeric block id, valid once the registry has been locked
+	using BlockId = uint16_t;
+
+	// Air is always id 0 so an id can be tested like a bool
+	inline constexpr BlockId s_AirBlock = 0;
+
+	struct BlockFace
+	{
+		BlockFace() = default;
+		BlockFace(size_t index);
+
+		size_t m_TextureIndex = -1;
+	};
+
+	struct Block
+	{
+		Block() = default;
+		Block(BlockFace* top, BlockFace* side, BlockFace* bottom);
+
+		BlockFace* m_Top = nullptr;
+		BlockFace* m_Side = nullptr;
+		BlockFace* m_Bottom = nullptr;
+	};
+
+	// Frozen per block data, texture layers are stored inline indexed by side, 0 is top, 1 is side, 2 is bottom
+	struct BlockInfo
+	{
+		std::string m_Name;
+		std::array<uint32_t, 3> m_Textures = { 0, 0, 0 };
+	};
+
+	BlockFace* GetBlockFace(const std::string& id);
+
+	void RegisterBlockFace(const std::string& id, const BlockFace& face);
+	void RegisterBlock(const std::string& id, const Block& block);
+
+	// Freezes the registry, blocks are assigned ids in name order so they stay stable between runs
+	void LockModify();
+
+	// String lookup, meant for load time only, returns air if the block does not exist
+	BlockId GetBlockId(const std::string& id);
+
+	const BlockInfo& GetBlockInfo(BlockId id);
+	size_t GetBlockCount();
+}
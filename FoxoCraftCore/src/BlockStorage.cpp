@@ -0,0 +1,341 @@
+#include "BlockStorage.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+#include "ByteStream.h"
+
+namespace FoxoCraft
+{
+	static size_t WordCount(size_t size, uint32_t bits)
+	{
+		return (size * bits + 63) / 64;
+	}
+
+	// Rows of 32 solid bits from words packed Bits wide, solid maps a packed byte to the solid bits of its cells
+	// Bits is a template argument so the byte shifts are constants the compiler can unroll
+	template<uint32_t Bits>
+	static void DecodeOccupancy(const uint64_t* words, const std::array<uint8_t, 256>& solid, size_t begin, size_t rows, size_t stride, uint32_t* out)
+	{
+		constexpr uint32_t cellsPerByte = 8 / Bits;
+		constexpr uint32_t cellsPerWord = 64 / Bits;
+
+		for (size_t r = 0; r < rows; ++r)
+		{
+			size_t cell = begin + r * stride;
+			size_t word = cell / cellsPerWord;
+
+			// a row starting halfway through a word skips the cells before it
+			uint32_t skip = static_cast<uint32_t>(cell % cellsPerWord);
+
+			uint64_t bits = 0;
+
+			for (uint32_t have = 0; have < 32; skip = 0)
+			{
+				uint64_t packed = words[word++];
+				uint64_t cells = 0;
+
+				for (uint32_t k = 0; k < 8; ++k)
+					cells |= static_cast<uint64_t>(solid[(packed >> (k * 8)) & 0xFF]) << (k * cellsPerByte);
+
+				bits |= (cells >> skip) << have;
+				have += cellsPerWord - skip;
+			}
+
+			out[r] = static_cast<uint32_t>(bits);
+		}
+	}
+
+	// Gathers the even bits of x into the low 32 bits
+	static inline uint32_t CompactEvenBits(uint64_t x)
+	{
+		x &= 0x5555555555555555ull;
+		x = (x | (x >> 1)) & 0x3333333333333333ull;
+		x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0Full;
+		x = (x | (x >> 4)) & 0x00FF00FF00FF00FFull;
+		x = (x | (x >> 8)) & 0x0000FFFF0000FFFFull;
+		x = (x | (x >> 16)) & 0x00000000FFFFFFFFull;
+		return static_cast<uint32_t>(x);
+	}
+
+	// Two bit cells without a table, a row is exactly one word
+	// The low and high index bits of every cell are split into two 32 bit planes, each palette index matches where both planes agree with it
+	static void DecodeOccupancy2(const uint64_t* words, const std::array<uint32_t, 4>& solid, size_t begin, size_t rows, size_t stride, uint32_t* out)
+	{
+		for (size_t r = 0; r < rows; ++r)
+		{
+			uint64_t packed = words[(begin + r * stride) / 32];
+			uint32_t low = CompactEvenBits(packed);
+			uint32_t high = CompactEvenBits(packed >> 1);
+
+			out[r] = (solid[0] & ~low & ~high) | (solid[1] & low & ~high) | (solid[2] & ~low & high) | (solid[3] & low & high);
+		}
+	}
+
+	BlockStorage::BlockStorage(size_t size)
+		: m_Size(size)
+	{
+		// storage starts out uniformly air and only allocates words on the first differing set
+		m_Palette.push_back(s_AirBlock);
+	}
+
+	BlockId BlockStorage::Get(size_t index) const
+	{
+		return m_Palette[GetPaletteIndex(index)];
+	}
+
+	void BlockStorage::GetOccupancy(size_t begin, size_t rows, size_t stride, uint32_t* out) const
+	{
+		if (m_Bits == 0)
+		{
+			std::fill(out, out + rows, m_Palette[0] != s_AirBlock ? ~uint32_t(0) : 0);
+			return;
+		}
+
+		// cells wider than a byte only happen with more than 256 blocks in one chunk
+		if (m_Bits > 8)
+		{
+			for (size_t r = 0; r < rows; ++r)
+			{
+				uint32_t bits = 0;
+
+				for (uint32_t i = 0; i < 32; ++i)
+					bits |= static_cast<uint32_t>(Get(begin + r * stride + i) != s_AirBlock) << i;
+
+				out[r] = bits;
+			}
+
+			return;
+		}
+
+		// the common widths compare index bits directly, all ones for palette indices that are solid
+		if (m_Bits <= 2)
+		{
+			std::array<uint32_t, 4> solid = {};
+
+			for (size_t i = 0; i < m_Palette.size(); ++i)
+				solid[i] = m_Palette[i] != s_AirBlock ? ~uint32_t(0) : 0;
+
+			if (m_Bits == 2)
+			{
+				DecodeOccupancy2(m_Words.data(), solid, begin, rows, stride, out);
+				return;
+			}
+
+			// one bit cells, a row is half a word
+			for (size_t r = 0; r < rows; ++r)
+			{
+				size_t cell = begin + r * stride;
+				uint32_t index = static_cast<uint32_t>(m_Words[cell / 64] >> (cell % 64));
+				out[r] = (solid[0] & ~index) | (solid[1] & index);
+			}
+
+			return;
+		}
+
+		// solid bits of every byte value, a byte holds 8 / m_Bits whole cells
+		// the low cell of a byte is its palette index, the others are the byte shifted down by one cell, which is a smaller value
+		uint32_t cellsPerByte = 8 / m_Bits;
+		uint32_t mask = (1u << m_Bits) - 1;
+		uint32_t byteMask = (1u << cellsPerByte) - 1;
+		std::array<uint8_t, 256> solid;
+
+		solid[0] = m_Palette[0] != s_AirBlock ? static_cast<uint8_t>(byteMask) : 0;
+
+		for (uint32_t value = 1; value < 256; ++value)
+		{
+			uint32_t index = value & mask;
+			uint32_t low = index < m_Palette.size() && m_Palette[index] != s_AirBlock;
+			solid[value] = static_cast<uint8_t>((low | solid[value >> m_Bits] << 1) & byteMask);
+		}
+
+		const uint64_t* words = m_Words.data();
+
+		if (m_Bits == 4)
+			DecodeOccupancy<4>(words, solid, begin, rows, stride, out);
+		else
+			DecodeOccupancy<8>(words, solid, begin, rows, stride, out);
+	}
+
+	void BlockStorage::Set(size_t index, BlockId block)
+	{
+		SetPaletteIndex(index, FindOrAddPalette(block));
+	}
+
+	void BlockStorage::Fill(BlockId block)
+	{
+		m_Palette.assign(1, block);
+		m_Bits = 0;
+		std::vector<uint64_t>().swap(m_Words);
+	}
+
+	size_t BlockStorage::GetPaletteSize() const
+	{
+		return m_Palette.size();
+	}
+
+	uint32_t BlockStorage::GetBits() const
+	{
+		return m_Bits;
+	}
+
+	bool BlockStorage::IsUniform() const
+	{
+		return m_Bits == 0;
+	}
+
+	void BlockStorage::Optimize()
+	{
+		if (m_Bits == 0) return;
+
+		std::vector<size_t> counts(m_Palette.size(), 0);
+
+		for (size_t i = 0; i < m_Size; ++i)
+			++counts[GetPaletteIndex(i)];
+
+		std::vector<BlockId> palette;
+		std::vector<uint32_t> remap(m_Palette.size(), 0);
+
+		for (size_t i = 0; i < m_Palette.size(); ++i)
+		{
+			if (counts[i] == 0) continue;
+
+			remap[i] = static_cast<uint32_t>(palette.size());
+			palette.push_back(m_Palette[i]);
+		}
+
+		if (palette.size() == m_Palette.size()) return;
+
+		if (palette.size() <= 1)
+		{
+			if (palette.empty()) palette.push_back(m_Palette[0]);
+
+			m_Palette = std::move(palette);
+			m_Bits = 0;
+			std::vector<uint64_t>().swap(m_Words);
+			return;
+		}
+
+		uint32_t bits = 1;
+		while (palette.size() > (size_t(1) << bits)) bits *= 2;
+
+		std::vector<uint64_t> words(WordCount(m_Size, bits), 0);
+
+		for (size_t i = 0; i < m_Size; ++i)
+		{
+			size_t bit = i * bits;
+			words[bit >> 6] |= static_cast<uint64_t>(remap[GetPaletteIndex(i)]) << (bit & 63);
+		}
+
+		m_Palette = std::move(palette);
+		m_Bits = bits;
+		m_Words = std::move(words);
+	}
+
+	size_t BlockStorage::GetMemoryUsage() const
+	{
+		return m_Palette.capacity() * sizeof(BlockId) + m_Words.capacity() * sizeof(uint64_t);
+	}
+
+	void BlockStorage::Serialize(std::vector<uint8_t>& out, const std::vector<uint16_t>& remap) const
+	{
+		ByteWriter writer(out);
+		writer.Write(static_cast<uint8_t>(m_Bits));
+		writer.Write(static_cast<uint16_t>(m_Palette.size()));
+
+		for (BlockId block : m_Palette)
+			writer.Write(remap[block]);
+
+		writer.WriteBytes(m_Words.data(), m_Words.size() * sizeof(uint64_t));
+	}
+
+	bool BlockStorage::Deserialize(const uint8_t* data, size_t size, const std::vector<BlockId>& remap)
+	{
+		ByteReader reader(data, size);
+		uint32_t bits = reader.Read<uint8_t>();
+		size_t paletteSize = reader.Read<uint16_t>();
+
+		if (reader.m_Failed || bits > 16 || (bits & (bits - 1)) != 0) return false;
+		if (paletteSize == 0 || paletteSize > (size_t(1) << bits)) return false;
+
+		BlockStorage loaded(m_Size);
+		loaded.m_Bits = bits;
+		loaded.m_Palette.resize(paletteSize);
+		loaded.m_Words.resize(WordCount(m_Size, bits));
+
+		for (BlockId& block : loaded.m_Palette)
+		{
+			uint16_t saved = reader.Read<uint16_t>();
+
+			// blocks that no longer exist turn into air
+			block = saved < remap.size() ? remap[saved] : s_AirBlock;
+		}
+
+		if (!reader.ReadBytes(loaded.m_Words.data(), loaded.m_Words.size() * sizeof(uint64_t)) || reader.m_Pos != size) return false;
+
+		// indices past the palette would read out of bounds later, check them once here
+		if (paletteSize != (size_t(1) << bits))
+		{
+			for (size_t i = 0; i < m_Size; ++i)
+			{
+				if (loaded.GetPaletteIndex(i) >= paletteSize) return false;
+			}
+		}
+
+		*this = std::move(loaded);
+		return true;
+	}
+
+	uint32_t BlockStorage::GetPaletteIndex(size_t index) const
+	{
+		if (m_Bits == 0) return 0;
+
+		// bits is always a power of two, shifts and masks are enough to locate a cell
+		size_t bit = index * m_Bits;
+		uint64_t mask = (uint64_t(1) << m_Bits) - 1;
+		return static_cast<uint32_t>((m_Words[bit >> 6] >> (bit & 63)) & mask);
+	}
+
+	void BlockStorage::SetPaletteIndex(size_t index, uint32_t value)
+	{
+		// a uniform storage can only be asked to store its single value
+		if (m_Bits == 0) return;
+
+		size_t bit = index * m_Bits;
+		uint64_t mask = (uint64_t(1) << m_Bits) - 1;
+		uint64_t& word = m_Words[bit >> 6];
+		word &= ~(mask << (bit & 63));
+		word |= (static_cast<uint64_t>(value) & mask) << (bit & 63);
+	}
+
+	uint32_t BlockStorage::FindOrAddPalette(BlockId block)
+	{
+		for (size_t i = 0; i < m_Palette.size(); ++i)
+		{
+			if (m_Palette[i] == block)
+				return static_cast<uint32_t>(i);
+		}
+
+		m_Palette.push_back(block);
+
+		if (m_Palette.size() > (size_t(1) << m_Bits))
+			Widen(m_Bits == 0 ? 1 : m_Bits * 2);
+
+		return static_cast<uint32_t>(m_Palette.size() - 1);
+	}
+
+	void BlockStorage::Widen(uint32_t bits)
+	{
+		std::vector<uint64_t> words(WordCount(m_Size, bits), 0);
+
+		for (size_t i = 0; i < m_Size; ++i)
+		{
+			size_t bit = i * bits;
+			words[bit >> 6] |= static_cast<uint64_t>(GetPaletteIndex(i)) << (bit & 63);
+		}
+
+		m_Bits = bits;
+		m_Words = std::move(words);
+	}
+}
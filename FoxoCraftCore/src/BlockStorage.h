@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Block.h"
+
+namespace FoxoCraft
+{
+	// Palette compressed block storage
+	// Each cell stores an index into a small palette of unique blocks, indices are bit packed into 64 bit words
+	// The index width doubles whenever the palette outgrows it, so a value never straddles two words
+	// A storage with a single palette entry is uniform, it uses 0 bits per cell and owns no words at all
+	class BlockStorage final
+	{
+	public:
+		BlockStorage(size_t size);
+
+		BlockId Get(size_t index) const;
+		void Set(size_t index, BlockId block);
+
+		// One word per row of 32 cells, bit i set where the block at begin + r * stride + i is not air
+		// begin and stride must be multiples of 32, one and two bit indices are matched a word at a time, wider ones decoded a byte at a time through a table
+		void GetOccupancy(size_t begin, size_t rows, size_t stride, uint32_t* out) const;
+
+		// Sets every cell to block and releases the packed words
+		void Fill(BlockId block);
+
+		size_t GetPaletteSize() const;
+		uint32_t GetBits() const;
+
+		// True when every cell holds the same block, Get(0) is that block
+		bool IsUniform() const;
+
+		// Drops unused palette entries and narrows the indices, collapses to the uniform state when possible
+		void Optimize();
+
+		// Heap memory owned by this storage in bytes
+		size_t GetMemoryUsage() const;
+
+		// Appends the palette and packed words to out, every palette entry is written as remap[block]
+		void Serialize(std::vector<uint8_t>& out, const std::vector<uint16_t>& remap) const;
+
+		// Replaces the contents with serialized data of the same size, palette entries are read back through remap
+		// Returns false and leaves the storage untouched if the data is malformed
+		bool Deserialize(const uint8_t* data, size_t size, const std::vector<BlockId>& remap);
+	private:
+		uint32_t GetPaletteIndex(size_t index) const;
+		void SetPaletteIndex(size_t index, uint32_t value);
+		uint32_t FindOrAddPalette(BlockId block);
+		void Widen(uint32_t bits);
+	private:
+		size_t m_Size = 0;
+		uint32_t m_Bits = 0;
+		std::vector<BlockId> m_Palette;
+		std::vector<uint64_t> m_Words;
+	};
+}
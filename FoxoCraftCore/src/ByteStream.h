@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace FoxoCraft
+{
+	// Appends trivially copyable values to a byte buffer in host byte order, save files are only read back on little endian machines
+	struct ByteWriter
+	{
+		std::vector<uint8_t>& m_Data;
+
+		ByteWriter(std::vector<uint8_t>& data)
+			: m_Data(data)
+		{
+		}
+
+		template<typename T>
+		void Write(const T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			WriteBytes(&value, sizeof(T));
+		}
+
+		void WriteBytes(const void* data, size_t size)
+		{
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			m_Data.insert(m_Data.end(), bytes, bytes + size);
+		}
+	};
+
+	// Reads values written by ByteWriter, reading past the end sets m_Failed and yields zeroes
+	struct ByteReader
+	{
+		const uint8_t* m_Data = nullptr;
+		size_t m_Size = 0;
+		size_t m_Pos = 0;
+		bool m_Failed = false;
+
+		ByteReader(const uint8_t* data, size_t size)
+			: m_Data(data), m_Size(size)
+		{
+		}
+
+		template<typename T>
+		T Read()
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			T value{};
+			ReadBytes(&value, sizeof(T));
+			return value;
+		}
+
+		bool ReadBytes(void* data, size_t size)
+		{
+			if (m_Failed || size > m_Size - m_Pos)
+			{
+				m_Failed = true;
+				return false;
+			}
+
+			if (size != 0) std::memcpy(data, m_Data + m_Pos, size);
+			m_Pos += size;
+			return true;
+		}
+	};
+}
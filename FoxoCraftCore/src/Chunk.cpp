@@ -0,0 +1,787 @@
+#include "Chunk.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <tuple>
+
+#include "ChunkMesher.h"
+#include "Log.h"
+#include <FoxoCommons/FrustumCull.h>
+
+namespace FoxoCraft
+{
+	Chunk::Chunk(glm::ivec3 pos, World* world)
+	{
+		m_Pos = pos;
+		m_World = world;
+	}
+
+	bool Chunk::InBoundsLS(glm::ivec3 ls)
+	{
+		if (ls.x < 0) return false;
+		if (ls.y < 0) return false;
+		if (ls.z < 0) return false;
+		if (ls.x >= s_ChunkSize) return false;
+		if (ls.y >= s_ChunkSize) return false;
+		if (ls.z >= s_ChunkSize) return false;
+
+		return true;
+	}
+
+	glm::ivec3 Chunk::WSLS(glm::ivec3 ws)
+	{
+		ws -= m_Pos * static_cast<int>(s_ChunkSize);
+		return ws;
+	}
+
+	BlockId Chunk::GetBlockLSUS(glm::ivec3 ls)
+	{
+		return m_Data->Get(IndexLS(ls));
+	}
+
+	BlockId Chunk::GetBlockLS(glm::ivec3 ls)
+	{
+		if (!InBoundsLS(ls)) return s_AirBlock;
+		return GetBlockLSUS(ls);
+	}
+
+
+	BlockId Chunk::GetBlockWSEX(glm::ivec3 ws)
+	{
+		glm::ivec3 ls = WSLS(ws);
+
+		if (InBoundsLS(ls)) return GetBlockLSUS(ls);
+
+		// positions outside along a single axis resolve through the neighbor cache, anything diagonal asks the world
+		int neighbor = -1;
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			if (ls[axis] >= 0 && ls[axis] < s_ChunkSize) continue;
+
+			if (neighbor != -1)
+				return m_World->GetBlockWS(ws);
+
+			neighbor = axis * 2 + (ls[axis] < 0 ? 0 : 1);
+			ls[axis] += ls[axis] < 0 ? static_cast<int>(s_ChunkSize) : -static_cast<int>(s_ChunkSize);
+		}
+
+		Chunk* chunk = m_Neighbors[neighbor];
+		if (!chunk) return s_AirBlock;
+
+		return chunk->GetBlockLS(ls);
+	}
+
+	void Chunk::SetBlockLS(glm::ivec3 ls, BlockId block)
+	{
+		if (!InBoundsLS(ls)) return;
+		if (GetBlockLSUS(ls) == block) return;
+
+		// storage still referenced by a snapshot is copied before it changes
+		// use_count is a relaxed load, the fence orders it after the reads of the thread that released the last snapshot
+		if (m_Data.use_count() > 1)
+			m_Data = std::make_shared<BlockStorage>(*m_Data);
+		else
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+		m_Data->Set(IndexLS(ls), block);
+		m_Dirty = true;
+		m_Modified = true;
+	}
+
+	void Chunk::Generate()
+	{
+		FC_PROFILE_SCOPE("Generate chunk");
+
+		WorldGenerator& generator = m_World->m_Generator;
+		std::shared_ptr<const Heightmap> heightmap = generator.GetHeightmap(glm::ivec2(m_Pos.x, m_Pos.z));
+
+		int bottom = m_Pos.y * static_cast<int>(s_ChunkSize);
+		int top = bottom + static_cast<int>(s_ChunkSize) - 1;
+
+		// chunks entirely above the surface stay air, chunks entirely below the dirt layer are solid stone
+		if (bottom > heightmap->m_Max) return;
+
+		if (top < heightmap->m_Min - 3)
+		{
+			m_Data->Fill(generator.m_Stone);
+			return;
+		}
+
+		glm::ivec3 ws;
+		glm::ivec3 ls;
+
+		for (ls.z = 0; ls.z < s_ChunkSize; ++ls.z)
+		{
+			for (ls.x = 0; ls.x < s_ChunkSize; ++ls.x)
+			{
+				int height = heightmap->m_Heights[ls.z * s_ChunkSize + ls.x];
+
+				for (ls.y = 0; ls.y < s_ChunkSize; ++ls.y)
+				{
+					ws.y = ls.y + bottom;
+
+					if (ws.y < height)
+					{
+						if (ws.y < height - 3) SetBlockLS(ls, generator.m_Stone);
+						else SetBlockLS(ls, generator.m_Dirt);
+					}
+
+					if (ws.y == height)
+						SetBlockLS(ls, generator.m_Grass);
+				}
+			}
+		}
+
+		// chunks entirely above or below the surface collapse back to a single value
+		m_Data->Optimize();
+	}
+
+	ChunkSnapshot Chunk::Snapshot()
+	{
+		ChunkSnapshot snapshot;
+		snapshot.m_Pos = m_Pos;
+		snapshot.m_Revision = m_MeshRevision;
+		snapshot.m_Data = m_Data;
+		snapshot.m_VertexHint = m_VertexCount;
+
+		for (size_t i = 0; i < 6; ++i)
+		{
+			if (m_Neighbors[i])
+				snapshot.m_Neighbors[i] = m_Neighbors[i]->m_Data;
+		}
+
+		return snapshot;
+	}
+
+	size_t Chunk::GetMemoryUsage()
+	{
+		return sizeof(Chunk) + sizeof(BlockStorage) + m_Data->GetMemoryUsage();
+	}
+
+	// OpenSimplexNoise makes no thread safety promises, each thread keeps its own instance for the seed it last used
+	static OpenSimplexNoise& GetThreadNoise(int64_t seed)
+	{
+		thread_local bool s_Valid = false;
+		thread_local int64_t s_Seed = 0;
+		thread_local OpenSimplexNoise s_Noise;
+
+		if (!s_Valid || s_Seed != seed)
+		{
+			s_Noise = OpenSimplexNoise(seed);
+			s_Seed = seed;
+			s_Valid = true;
+		}
+
+		return s_Noise;
+	}
+
+	WorldGenerator::WorldGenerator(int64_t seed)
+		: m_Seed(seed)
+	{
+		m_Grass = GetBlockId("core.grass");
+		m_Dirt = GetBlockId("core.dirt");
+		m_Stone = GetBlockId("core.stone");
+	}
+
+	std::shared_ptr<const Heightmap> WorldGenerator::GetHeightmap(glm::ivec2 column)
+	{
+		glm::ivec3 key = glm::ivec3(column.x, 0, column.y);
+
+		{
+			std::lock_guard<std::mutex> lock(m_HeightmapMutex);
+
+			if (HeightmapEntry* entry = m_Heightmaps.Find(key))
+			{
+				++m_HeightmapHits;
+				m_HeightmapUse.splice(m_HeightmapUse.begin(), m_HeightmapUse, entry->m_Use);
+				return entry->m_Heightmap;
+			}
+		}
+
+		++m_HeightmapMisses;
+
+		// noise is evaluated outside the lock, two workers racing on one column both compute it and the first one is kept
+		std::shared_ptr<const Heightmap> heightmap = GenerateHeightmap(column);
+
+		std::lock_guard<std::mutex> lock(m_HeightmapMutex);
+
+		if (HeightmapEntry* entry = m_Heightmaps.Find(key))
+			return entry->m_Heightmap;
+
+		while (!m_HeightmapUse.empty() && m_Heightmaps.Size() >= m_HeightmapCapacity)
+		{
+			m_Heightmaps.Erase(m_HeightmapUse.back());
+			m_HeightmapUse.pop_back();
+		}
+
+		m_HeightmapUse.push_front(key);
+		m_Heightmaps.Insert(key, HeightmapEntry{ heightmap, m_HeightmapUse.begin() });
+		return heightmap;
+	}
+
+	size_t WorldGenerator::GetHeightmapCount()
+	{
+		std::lock_guard<std::mutex> lock(m_HeightmapMutex);
+		return m_Heightmaps.Size();
+	}
+
+	std::shared_ptr<Heightmap> WorldGenerator::GenerateHeightmap(glm::ivec2 column)
+	{
+		constexpr const std::array<glm::dvec2, 4> s_MapOffsets =
+		{
+			glm::dvec2(9134542, 312781),
+			glm::dvec2(3320191, -554605),
+			glm::dvec2(-9743106, 761011),
+			glm::dvec2(-4211348, -812416)
+		};
+
+		OpenSimplexNoise& noise = GetThreadNoise(m_Seed);
+
+		std::shared_ptr<Heightmap> heightmap = std::make_shared<Heightmap>();
+		heightmap->m_Min = std::numeric_limits<int>::max();
+		heightmap->m_Max = std::numeric_limits<int>::lowest();
+
+		glm::ivec2 ws;
+		glm::ivec2 ls;
+
+		for (ls.y = 0; ls.y < s_ChunkSize; ++ls.y)
+		{
+			ws.y = ls.y + column.y * s_ChunkSize;
+
+			for (ls.x = 0; ls.x < s_ChunkSize; ++ls.x)
+			{
+				ws.x = ls.x + column.x * s_ChunkSize;
+
+				double dheight = 0.;
+
+				double factor = 128.0f;
+				double factor2 = 64.0f;
+				for (size_t i = 0; i < s_MapOffsets.size(); ++i)
+				{
+					dheight += noise.Evaluate((ws.x + s_MapOffsets[i].x) / factor, (ws.y + s_MapOffsets[i].y) / factor) * factor2;
+					factor *= 0.5f;
+					factor2 *= 0.5f;
+				}
+
+				int height = static_cast<int>(dheight);
+
+				heightmap->m_Heights[ls.y * s_ChunkSize + ls.x] = height;
+				heightmap->m_Min = std::min(heightmap->m_Min, height);
+				heightmap->m_Max = std::max(heightmap->m_Max, height);
+			}
+		}
+
+		return heightmap;
+	}
+
+	World::World(int64_t seed, std::unique_ptr<WorldStorage> storage)
+		: m_Generator(seed), m_Storage(std::move(storage))
+	{
+		if (m_Storage) m_Saver = std::make_unique<ChunkSaver>(*m_Storage);
+	}
+
+	World::~World()
+	{
+		// jobs still in flight reference the world
+		m_Jobs.Wait();
+
+		Save();
+	}
+
+	void World::AddChunks(glm::vec3 center)
+	{
+		int radius = 3;
+
+		m_StreamCenter = GetChunkPos(center);
+
+		auto start = std::chrono::steady_clock::now();
+
+		glm::ivec3 cs;
+
+		for (cs.z = -radius; cs.z <= radius; ++cs.z)
+		{
+			for (cs.y = -radius; cs.y <= radius; ++cs.y)
+			{
+				for (cs.x = -radius; cs.x <= radius; ++cs.x)
+				{
+					GenerateChunk(m_StreamCenter + cs);
+				}
+			}
+		}
+
+		m_Jobs.Wait();
+		PublishChunks();
+
+		double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		FC_LOG_INFO("Generated {} chunks in {:.1f} ms on {} threads", m_Chunks.Size(), elapsed * 1000.0, m_Jobs.GetThreadCount());
+	}
+
+	void World::GenerateChunk(glm::ivec3 cs)
+	{
+		m_Loading.Insert(cs, 1);
+
+		m_Jobs.Submit([this, cs]()
+		{
+			std::shared_ptr<Chunk> chunk = std::make_shared<Chunk>(cs, this);
+
+			auto start = std::chrono::steady_clock::now();
+
+			// an unloaded chunk may still be waiting for its write
+			std::shared_ptr<const BlockStorage> pending = m_Saver ? m_Saver->Find(cs) : nullptr;
+			if (pending) *chunk->m_Data = *pending;
+
+			bool loaded = pending || (m_Storage && m_Storage->LoadChunk(cs, *chunk->m_Data));
+			if (!loaded) chunk->Generate();
+
+			// a newly generated chunk is written once, later launches load it instead of generating it again
+			chunk->m_Modified = !loaded && m_Storage;
+
+			double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			std::lock_guard<std::mutex> lock(m_GeneratedMutex);
+			m_Generated.push_back({ std::move(chunk), time, loaded });
+		});
+	}
+
+	void World::PublishChunks()
+	{
+		FC_PROFILE_SCOPE("Publish chunks");
+
+		std::vector<GeneratedChunk> generated;
+
+		{
+			std::lock_guard<std::mutex> lock(m_GeneratedMutex);
+			std::swap(generated, m_Generated);
+		}
+
+		// workers finish in any order, the map layout and with it every later iteration order follow the insertion order
+		if (m_Lockstep)
+		{
+			std::sort(generated.begin(), generated.end(), [](const GeneratedChunk& a, const GeneratedChunk& b)
+			{
+				glm::ivec3 pa = a.m_Chunk->m_Pos;
+				glm::ivec3 pb = b.m_Chunk->m_Pos;
+				return std::tie(pa.x, pa.y, pa.z) < std::tie(pb.x, pb.y, pb.z);
+			});
+		}
+
+		for (auto& entry : generated)
+		{
+			if (entry.m_Loaded)
+			{
+				m_LoadTime += entry.m_Time;
+				++m_ChunksLoaded;
+			}
+			else
+			{
+				m_GenerationTime += entry.m_Time;
+				++m_ChunksGenerated;
+			}
+
+			glm::ivec3 cs = entry.m_Chunk->m_Pos;
+			m_Loading.Erase(cs);
+
+			// the player moved away while the chunk was generating
+			if (!InStreamRadius(cs, s_StreamHysteresis)) continue;
+
+			InsertChunk(std::move(entry.m_Chunk));
+		}
+	}
+
+	glm::ivec3 World::GetChunkPos(glm::vec3 ws)
+	{
+		return glm::ivec3(glm::floor(ws / static_cast<float>(s_ChunkSize)));
+	}
+
+	bool World::InStreamRadius(glm::ivec3 cs, int extra) const
+	{
+		glm::ivec3 offset = cs - m_StreamCenter;
+		int radius = m_ViewRadius + extra;
+
+		return offset.x * offset.x + offset.z * offset.z <= radius * radius && std::abs(offset.y) <= m_ViewHeight + extra;
+	}
+
+	void World::StreamChunks(glm::vec3 center, const Frustum& frustum, DebugData& data)
+	{
+		FC_PROFILE_SCOPE("Stream chunks");
+
+		if (data.viewRadius != m_ViewRadius)
+		{
+			m_ViewRadius = data.viewRadius;
+			m_StreamComplete = false;
+		}
+
+		glm::ivec3 centerChunk = GetChunkPos(center);
+
+		if (centerChunk != m_StreamCenter)
+		{
+			m_StreamCenter = centerChunk;
+			m_StreamComplete = false;
+		}
+
+		if (!m_StreamComplete)
+		{
+			// unload first so the arena space is free for the new chunks
+			// modified chunks that do not fit into the save queue stay loaded until a later frame
+			std::vector<glm::ivec3> unload;
+			bool deferred = false;
+
+			for (auto& [k, v] : m_Chunks)
+			{
+				if (InStreamRadius(k, s_StreamHysteresis)) continue;
+
+				if (QueueSave(*v, false))
+					unload.push_back(k);
+				else
+					deferred = true;
+			}
+
+			for (glm::ivec3 cs : unload)
+				RemoveChunk(cs);
+
+			m_ChunksUnloaded += unload.size();
+
+			if (m_StreamRadius != m_ViewRadius || m_StreamHeight != m_ViewHeight)
+			{
+				m_StreamRadius = m_ViewRadius;
+				m_StreamHeight = m_ViewHeight;
+				m_StreamOffsets.clear();
+
+				glm::ivec3 offset;
+
+				for (offset.z = -m_ViewRadius; offset.z <= m_ViewRadius; ++offset.z)
+				{
+					for (offset.y = -m_ViewHeight; offset.y <= m_ViewHeight; ++offset.y)
+					{
+						for (offset.x = -m_ViewRadius; offset.x <= m_ViewRadius; ++offset.x)
+						{
+							if (InStreamRadius(m_StreamCenter + offset, 0))
+								m_StreamOffsets.push_back(offset);
+						}
+					}
+				}
+
+				std::stable_sort(m_StreamOffsets.begin(), m_StreamOffsets.end(), [](glm::ivec3 a, glm::ivec3 b)
+				{
+					return a.x * a.x + a.y * a.y + a.z * a.z < b.x * b.x + b.y * b.y + b.z * b.z;
+				});
+			}
+
+			// gather the nearest missing chunks, then generate the visible ones before the rest
+			size_t budget = m_GenerationBudget > m_Loading.Size() ? m_GenerationBudget - m_Loading.Size() : 0;
+			std::vector<glm::ivec3> missing;
+			bool complete = true;
+
+			for (glm::ivec3 offset : m_StreamOffsets)
+			{
+				glm::ivec3 cs = m_StreamCenter + offset;
+				if (m_Chunks.Contains(cs) || m_Loading.Contains(cs)) continue;
+
+				complete = false;
+				if (missing.size() >= budget * 4) break;
+				missing.push_back(cs);
+			}
+
+			std::stable_partition(missing.begin(), missing.end(), [&frustum](glm::ivec3 cs)
+			{
+				glm::vec3 chunkMin = glm::vec3(cs * static_cast<int>(s_ChunkSize));
+				return frustum.IsBoxVisible(chunkMin, chunkMin + static_cast<float>(s_ChunkSize));
+			});
+
+			if (missing.size() > budget) missing.resize(budget);
+
+			for (glm::ivec3 cs : missing)
+				GenerateChunk(cs);
+
+			m_StreamComplete = complete && !deferred;
+		}
+
+		data.chunksLoading = m_Loading.Size();
+		data.chunksUnloaded = m_ChunksUnloaded;
+	}
+
+	void World::InsertChunk(std::shared_ptr<Chunk> chunk)
+	{
+		RemoveChunk(chunk->m_Pos);
+
+		for (size_t i = 0; i < 6; ++i)
+		{
+			Chunk* neighbor = GetChunk(chunk->m_Pos + glm::ivec3(s_FaceDirections[i]));
+			chunk->m_Neighbors[i] = neighbor;
+
+			if (neighbor)
+			{
+				// faces are stored in opposing pairs, i ^ 1 is the side facing back
+				neighbor->m_Neighbors[i ^ 1] = chunk.get();
+				neighbor->m_Dirty = true;
+			}
+		}
+
+		glm::ivec3 cs = chunk->m_Pos;
+		m_Chunks.Insert(cs, std::move(chunk));
+	}
+
+	void World::RemoveChunk(glm::ivec3 cs)
+	{
+		Chunk* chunk = GetChunk(cs);
+		if (!chunk) return;
+
+		QueueSave(*chunk, true);
+
+		for (size_t i = 0; i < 6; ++i)
+		{
+			Chunk* neighbor = chunk->m_Neighbors[i];
+			if (!neighbor) continue;
+
+			neighbor->m_Neighbors[i ^ 1] = nullptr;
+			neighbor->m_Dirty = true;
+			chunk->m_Neighbors[i] = nullptr;
+		}
+
+		m_Chunks.Erase(cs);
+	}
+
+	void World::Save()
+	{
+		if (!m_Saver) return;
+
+		size_t saved = 0;
+
+		for (auto& [k, v] : m_Chunks)
+		{
+			if (!v->m_Modified) continue;
+
+			QueueSave(*v, true);
+			++saved;
+		}
+
+		m_Saver->Flush();
+
+		if (saved != 0) FC_LOG_INFO("Saved {} chunks", saved);
+	}
+
+	bool World::QueueSave(Chunk& chunk, bool wait)
+	{
+		if (!m_Saver || !chunk.m_Modified) return true;
+
+		// the next SetBlockLS copies the storage, the queued one never changes
+		bool queued = m_Saver->Queue(chunk.m_Pos, chunk.m_Data);
+
+		if (!queued && wait)
+		{
+			m_Saver->Flush();
+			queued = m_Saver->Queue(chunk.m_Pos, chunk.m_Data);
+		}
+
+		if (queued) chunk.m_Modified = false;
+		return queued;
+	}
+
+	void World::SaveModified()
+	{
+		FC_PROFILE_SCOPE("Queue saves");
+
+		if (!m_Saver) return;
+
+		auto now = std::chrono::steady_clock::now();
+		if (std::chrono::duration<double>(now - m_LastSave).count() < m_SaveInterval) return;
+
+		m_LastSave = now;
+
+		for (auto& [k, v] : m_Chunks)
+		{
+			if (!QueueSave(*v, false)) break;
+		}
+	}
+
+	Chunk* World::GetChunk(glm::ivec3 cs)
+	{
+		std::shared_ptr<Chunk>* result = m_Chunks.Find(cs);
+
+		if (!result)
+			return nullptr;
+
+		return result->get();
+	}
+
+	BlockId World::GetBlockWS(glm::vec3 ws)
+	{
+		return GetBlockWS(glm::ivec3(glm::floor(ws)));
+	}
+
+	BlockId World::GetBlockWS(glm::ivec3 ws)
+	{
+		glm::ivec3 cs;
+		cs.x = static_cast<int>(glm::floor(static_cast<float>(ws.x) / static_cast<float>(s_ChunkSize)));
+		cs.y = static_cast<int>(glm::floor(static_cast<float>(ws.y) / static_cast<float>(s_ChunkSize)));
+		cs.z = static_cast<int>(glm::floor(static_cast<float>(ws.z) / static_cast<float>(s_ChunkSize)));
+
+		std::shared_ptr<Chunk>* result = m_Chunks.Find(cs);
+
+		if (!result)
+			return s_AirBlock;
+
+		glm::ivec3 ls = ws - cs * static_cast<int>(s_ChunkSize);
+
+		return (*result)->GetBlockLS(ls);
+	}
+
+	void World::ScheduleMeshes(glm::vec3 viewPos, const Frustum& frustum, DebugData& data)
+	{
+		FC_PROFILE_SCOPE("Schedule meshes");
+
+		auto start = std::chrono::steady_clock::now();
+
+		m_MeshQueue.clear();
+
+		for (auto& [k, v] : m_Chunks)
+		{
+			if (!v->m_Dirty) continue;
+
+			glm::vec3 chunkMin = glm::vec3(k * static_cast<int>(s_ChunkSize));
+			glm::vec3 chunkMax = chunkMin + static_cast<float>(s_ChunkSize);
+			glm::vec3 offset = (chunkMin + chunkMax) * 0.5f - viewPos;
+
+			m_MeshQueue.push_back({ v.get(), frustum.IsBoxVisible(chunkMin, chunkMax), glm::dot(offset, offset) });
+		}
+
+		std::sort(m_MeshQueue.begin(), m_MeshQueue.end(), [](const MeshRequest& a, const MeshRequest& b)
+		{
+			if (a.m_Visible != b.m_Visible) return a.m_Visible;
+			return a.m_Distance < b.m_Distance;
+		});
+
+		size_t submitted = 0;
+		double elapsed = 0.0;
+
+		for (const MeshRequest& request : m_MeshQueue)
+		{
+			if (m_MeshesPending >= m_MeshBudget || (elapsed >= m_MeshTimeBudget && !m_Lockstep)) break;
+
+			Chunk* chunk = request.m_Chunk;
+			chunk->m_Dirty = false;
+			chunk->m_MeshRevision = ++m_NextMeshRevision;
+
+			++m_MeshesPending;
+			++m_ChunksMeshed;
+			++submitted;
+
+			m_Jobs.Submit([this, snapshot = chunk->Snapshot(), greedy = m_GreedyMeshing, vertices = TakeMeshBuffer(chunk->m_VertexCount)]() mutable
+			{
+				ChunkMesh mesh = BuildMeshV2(snapshot, greedy, std::move(vertices));
+
+				std::lock_guard<std::mutex> lock(m_MeshedMutex);
+				m_Meshed.push_back(std::move(mesh));
+				--m_MeshesPending;
+			});
+
+			elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		data.meshQueue = m_MeshQueue.size() - submitted;
+		data.meshScheduleTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void World::TakeMeshes(std::vector<ChunkMesh>& meshes)
+	{
+		std::lock_guard<std::mutex> lock(m_MeshedMutex);
+
+		for (auto& mesh : m_Meshed)
+		{
+			if (Chunk* chunk = GetChunk(mesh.m_Pos))
+				chunk->m_VertexCount = mesh.m_Count;
+
+			m_MeshAllocations += mesh.m_Allocations;
+			++m_MeshesTaken;
+
+			meshes.push_back(std::move(mesh));
+		}
+
+		m_Meshed.clear();
+	}
+
+	void World::RecycleMesh(ChunkMesh& mesh)
+	{
+		if (m_MeshBuffers.size() >= s_MaxMeshBuffers || !mesh.m_Vertices.capacity()) return;
+
+		mesh.m_Vertices.clear();
+		m_MeshBuffers.push_back(std::move(mesh.m_Vertices));
+	}
+
+	std::vector<uint32_t> World::TakeMeshBuffer(int vertexHint)
+	{
+		if (m_MeshBuffers.empty()) return {};
+
+		size_t words = static_cast<size_t>(vertexHint) * 2;
+		size_t best = 0;
+
+		for (size_t i = 1; i < m_MeshBuffers.size(); ++i)
+		{
+			size_t capacity = m_MeshBuffers[i].capacity();
+			size_t bestCapacity = m_MeshBuffers[best].capacity();
+
+			bool fits = capacity >= words;
+			bool bestFits = bestCapacity >= words;
+
+			if (fits != bestFits ? fits : (fits ? capacity < bestCapacity : capacity > bestCapacity))
+				best = i;
+		}
+
+		std::vector<uint32_t> buffer = std::move(m_MeshBuffers[best]);
+		m_MeshBuffers[best] = std::move(m_MeshBuffers.back());
+		m_MeshBuffers.pop_back();
+		return buffer;
+	}
+
+	void World::Update(glm::vec3 viewPos, const glm::mat4& projView, DebugData& data)
+	{
+		FC_PROFILE_SCOPE("World update");
+
+		Frustum f(projView);
+
+		if (m_Lockstep)
+			m_Jobs.Wait();
+
+		PublishChunks();
+		StreamChunks(viewPos, f, data);
+
+		if (data.enableGreedyMeshing != m_GreedyMeshing)
+		{
+			m_GreedyMeshing = data.enableGreedyMeshing;
+
+			for (auto& [k, v] : m_Chunks)
+				v->m_Dirty = true;
+		}
+
+		ScheduleMeshes(viewPos, f, data);
+		SaveModified();
+
+		data.chunksTotal = m_Chunks.Size();
+		data.chunksMemory = 0;
+		data.chunksUniform = 0;
+		data.meshesPending = m_MeshesPending;
+		data.meshAllocations = m_MeshAllocations;
+		data.meshesTaken = m_MeshesTaken;
+		m_MeshAllocations = 0;
+		m_MeshesTaken = 0;
+		data.generationTime = m_ChunksGenerated ? m_GenerationTime / m_ChunksGenerated : 0.0;
+		data.loadTime = m_ChunksLoaded ? m_LoadTime / m_ChunksLoaded : 0.0;
+		data.chunksLoaded = m_ChunksLoaded;
+		data.chunksSaved = m_Storage ? m_Storage->m_ChunksSaved.load() : 0;
+		data.bytesWritten = m_Storage ? m_Storage->m_BytesWritten.load() : 0;
+		data.saveQueue = m_Saver ? m_Saver->GetQueueDepth() : 0;
+		data.saveQueueCapacity = m_Saver ? m_Saver->GetCapacity() : 0;
+		data.heightmapsCached = m_Generator.GetHeightmapCount();
+		data.heightmapHits = m_Generator.m_HeightmapHits;
+		data.heightmapMisses = m_Generator.m_HeightmapMisses;
+
+		for (auto& [k, v] : m_Chunks)
+		{
+			data.chunksMemory += v->GetMemoryUsage();
+			if (v->m_Data->IsUniform()) ++data.chunksUniform;
+		}
+	}
+}
@@ -0,0 +1,329 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <glm/glm.hpp>
+
+#include <FoxoCommons/OpenSimplexNoise.h>
+#include "DebugInfo.h"
+#include "Block.h"
+#include "BlockStorage.h"
+#include "ChunkMap.h"
+#include "ChunkSaver.h"
+#include "JobSystem.h"
+#include "WorldStorage.h"
+
+class Frustum;
+
+namespace FoxoCraft
+{
+	inline constexpr size_t s_ChunkSize = 32;
+	inline constexpr size_t s_ChunkSize2 = s_ChunkSize * s_ChunkSize;
+	inline constexpr size_t s_ChunkSize3 = s_ChunkSize * s_ChunkSize * s_ChunkSize;
+
+	// Face directions in the order -x, +x, -y, +y, -z, +z, opposing faces differ only in the lowest bit
+	// W is the side, 0 is top, 1 is side, 2 is bottom
+	inline constexpr std::array<glm::ivec4, 6> s_FaceDirections =
+	{
+		glm::ivec4(-1, 0, 0, 1),
+		glm::ivec4(1, 0, 0, 1),
+		glm::ivec4(0, -1, 0, 2),
+		glm::ivec4(0, 1, 0, 0),
+		glm::ivec4(0, 0, -1, 1),
+		glm::ivec4(0, 0, 1, 1)
+	};
+
+	// Immutable view of a chunk and its face neighbors, lets the mesher run off the main thread
+	// Block storage is shared copy on write, the main thread copies a storage before modifying one a snapshot still holds
+	struct ChunkSnapshot
+	{
+		glm::ivec3 m_Pos = glm::ivec3(0, 0, 0);
+		uint64_t m_Revision = 0;
+		std::shared_ptr<const BlockStorage> m_Data;
+
+		// null where the neighbor is not loaded
+		std::array<std::shared_ptr<const BlockStorage>, 6> m_Neighbors;
+
+		// vertex count of the chunk's previous mesh, the mesher reserves for it up front
+		int m_VertexHint = 0;
+	};
+
+	// CPU side mesh produced by the mesher, uploaded to the gpu on the main thread
+	struct ChunkMesh
+	{
+		glm::ivec3 m_Pos = glm::ivec3(0, 0, 0);
+		uint64_t m_Revision = 0;
+		std::vector<uint32_t> m_Vertices;
+		int m_Count = 0;
+
+		// vertices the mesh would need with one quad per block face, equals m_Count unless greedy meshing merged faces
+		int m_NaiveCount = 0;
+
+		// buffer growths while meshing, zero once the mesher's scratch and the recycled buffer were large enough
+		int m_Allocations = 0;
+	};
+
+	struct World;
+
+	struct Chunk final
+	{
+		glm::ivec3 m_Pos = glm::ivec3(0, 0, 0);
+		World* m_World = nullptr;
+
+		// Face adjacent chunks in s_FaceDirections order, maintained by World when chunks are inserted or removed
+		std::array<Chunk*, 6> m_Neighbors = {};
+
+		// Copy on write, see ChunkSnapshot
+		std::shared_ptr<BlockStorage> m_Data = std::make_shared<BlockStorage>(s_ChunkSize3);
+		bool m_Dirty = true;
+
+		// set by SetBlockLS and on newly generated chunks of a saved world, the chunk differs from what is on disk
+		bool m_Modified = false;
+
+		// Revision of the last mesh requested, uploads of older revisions are discarded
+		// Drawn from World::m_NextMeshRevision, so a chunk streamed back in never matches a mesh of the one it replaced
+		uint64_t m_MeshRevision = 0;
+
+		// vertices of the last finished mesh, sizes the buffers of the next one
+		int m_VertexCount = 0;
+
+		Chunk(glm::ivec3 pos, World* world);
+
+		static inline size_t IndexLS(glm::ivec3 ls)
+		{
+			return ls.z * s_ChunkSize2 + ls.y * s_ChunkSize + ls.x;
+		}
+
+		bool InBoundsLS(glm::ivec3 ls);
+
+		glm::ivec3 WSLS(glm::ivec3 ws);
+
+		BlockId GetBlockLSUS(glm::ivec3 ls);
+
+		BlockId GetBlockLS(glm::ivec3 ls);
+
+		BlockId GetBlockWSEX(glm::ivec3 ws);
+
+		void SetBlockLS(glm::ivec3 ls, BlockId block);
+
+		void Generate();
+
+		// Captures the chunk and its neighbors for BuildMeshV2, main thread only
+		ChunkSnapshot Snapshot();
+
+		// Approximate memory held by this chunk in bytes, including block storage
+		size_t GetMemoryUsage();
+	};
+
+	// Terrain height for every x/z column of a vertical stack of chunks, indexed z * s_ChunkSize + x
+	struct Heightmap
+	{
+		std::array<int, s_ChunkSize2> m_Heights;
+		int m_Min = 0;
+		int m_Max = 0;
+	};
+
+	// Shared by every generation worker, GetHeightmap may be called from any thread
+	struct WorldGenerator
+	{
+		int64_t m_Seed;
+
+		// resolved once, generation only works on ids
+		BlockId m_Grass = s_AirBlock;
+		BlockId m_Dirt = s_AirBlock;
+		BlockId m_Stone = s_AirBlock;
+
+		// Heightmaps are shared by every chunk in a column, the least recently used columns are evicted past this count
+		size_t m_HeightmapCapacity = 1024;
+		std::atomic<size_t> m_HeightmapHits = 0;
+		std::atomic<size_t> m_HeightmapMisses = 0;
+
+		WorldGenerator(int64_t seed);
+
+		// Cached heightmap for the chunk column at x/z
+		std::shared_ptr<const Heightmap> GetHeightmap(glm::ivec2 column);
+
+		size_t GetHeightmapCount();
+	private:
+		struct HeightmapEntry
+		{
+			std::shared_ptr<const Heightmap> m_Heightmap;
+			std::list<glm::ivec3>::iterator m_Use;
+		};
+
+		std::shared_ptr<Heightmap> GenerateHeightmap(glm::ivec2 column);
+
+		// columns are keyed as (x, 0, z), front of the list is the most recently used
+		std::mutex m_HeightmapMutex;
+		ChunkMap<HeightmapEntry> m_Heightmaps;
+		std::list<glm::ivec3> m_HeightmapUse;
+	};
+
+	struct World
+	{
+		WorldGenerator m_Generator;
+		JobSystem m_Jobs;
+
+		// storage is optional, without it the world is generated every time and never saved
+		World(int64_t seed, std::unique_ptr<WorldStorage> storage = nullptr);
+		~World();
+
+		World(const World&) = delete;
+		World& operator=(const World&) = delete;
+
+		ChunkMap<std::shared_ptr<Chunk>> m_Chunks;
+
+		std::unique_ptr<WorldStorage> m_Storage;
+
+		// writes modified chunks to m_Storage in the background, null without storage
+		std::unique_ptr<ChunkSaver> m_Saver;
+
+		// total time spent in Chunk::Generate and the number of chunks generated
+		double m_GenerationTime = 0.0;
+		size_t m_ChunksGenerated = 0;
+
+		// mesh jobs submitted, a chunk is counted again every time it is remeshed
+		size_t m_ChunksMeshed = 0;
+
+		// total time spent loading chunks from m_Storage and the number of chunks loaded
+		double m_LoadTime = 0.0;
+		size_t m_ChunksLoaded = 0;
+
+		// Writes every modified chunk to m_Storage and waits until they are on disk
+		void Save();
+
+		// seconds between queueing modified chunks for saving, edits within one interval are written once
+		double m_SaveInterval = 1.0;
+
+		// Generates the chunks around center and waits for them, used to have ground under the player on the first frame
+		void AddChunks(glm::vec3 center);
+
+		// Loads a chunk from m_Storage or generates it on the job system, it is added to the world by the next PublishChunks
+		void GenerateChunk(glm::ivec3 cs);
+
+		// Loads missing chunks within the view radius of center, nearest and visible first, and unloads chunks past the hysteresis radius
+		void StreamChunks(glm::vec3 center, const Frustum& frustum, DebugData& data);
+
+		// horizontal and vertical load radius in chunks, chunks are unloaded s_StreamHysteresis chunks further out
+		int m_ViewRadius = 6;
+		int m_ViewHeight = 3;
+		static constexpr int s_StreamHysteresis = 2;
+
+		// chunk generations in flight at once, new ones are submitted every frame to refill it
+		size_t m_GenerationBudget = 32;
+
+		// mesh jobs in flight at once, kept small so the job queue never holds stale low priority work
+		size_t m_MeshBudget = 32;
+
+		// seconds per frame spent snapshotting and submitting dirty chunks
+		double m_MeshTimeBudget = 0.002;
+
+		// Update first waits for the jobs of the previous frame and ignores m_MeshTimeBudget
+		// Chunks generated and meshed per frame then only depend on the view, not on how fast the machine is
+		bool m_Lockstep = false;
+
+		// Moves finished chunks from the workers into the world, main thread only
+		void PublishChunks();
+
+		// Snapshots dirty chunks and meshes them on the job system within the mesh budgets
+		// Visible chunks go first, then the ones closest to viewPos
+		void ScheduleMeshes(glm::vec3 viewPos, const Frustum& frustum, DebugData& data);
+
+		// Moves the meshes finished since the last call to the back of meshes, main thread only
+		// A mesh is current while its revision matches the m_MeshRevision of the chunk at its position
+		void TakeMeshes(std::vector<ChunkMesh>& meshes);
+
+		// Returns the vertex buffer of an uploaded or dropped mesh, later mesh jobs reuse its capacity, main thread only
+		void RecycleMesh(ChunkMesh& mesh);
+
+		// mesher mode of the current meshes, changing it remeshes every chunk
+		bool m_GreedyMeshing = false;
+
+		// Adds a chunk to the world and links it with its neighbors
+		void InsertChunk(std::shared_ptr<Chunk> chunk);
+
+		// Unlinks and removes the chunk at cs, modified chunks are queued for saving first
+		void RemoveChunk(glm::ivec3 cs);
+
+		Chunk* GetChunk(glm::ivec3 cs);
+
+		BlockId GetBlockWS(glm::ivec3 ws);
+		BlockId GetBlockWS(glm::vec3 ws);
+
+		// Streams, meshes and saves chunks for one frame, viewPos drives chunk streaming
+		// Nothing here touches the gpu, drawing the meshes is up to the caller
+		void Update(glm::vec3 viewPos, const glm::mat4& projView, DebugData& data);
+	private:
+		struct GeneratedChunk
+		{
+			std::shared_ptr<Chunk> m_Chunk;
+			double m_Time = 0.0;
+			bool m_Loaded = false;
+		};
+
+		std::mutex m_GeneratedMutex;
+		std::vector<GeneratedChunk> m_Generated;
+
+		// Queues a modified chunk on m_Saver, returns false if the queue is full unless wait is set
+		bool QueueSave(Chunk& chunk, bool wait);
+
+		// Queues every modified chunk once m_SaveInterval has passed, chunks that do not fit wait for the next interval
+		void SaveModified();
+
+		std::chrono::steady_clock::time_point m_LastSave = std::chrono::steady_clock::now();
+
+		static glm::ivec3 GetChunkPos(glm::vec3 ws);
+		bool InStreamRadius(glm::ivec3 cs, int extra) const;
+
+		// chunk the streaming radius is centered on
+		glm::ivec3 m_StreamCenter = glm::ivec3(0, 0, 0);
+
+		// offsets within the view radius sorted by distance, rebuilt when the radius changes
+		std::vector<glm::ivec3> m_StreamOffsets;
+		int m_StreamRadius = 0;
+		int m_StreamHeight = 0;
+
+		// set once every chunk around the center is loaded or loading, cleared when the center or radius changes
+		bool m_StreamComplete = false;
+
+		// chunks submitted to GenerateChunk and not yet published
+		ChunkMap<uint8_t> m_Loading;
+		size_t m_ChunksUnloaded = 0;
+
+		struct MeshRequest
+		{
+			Chunk* m_Chunk = nullptr;
+			bool m_Visible = false;
+			float m_Distance = 0.0f;
+		};
+
+		// dirty chunks of the current frame in priority order
+		std::vector<MeshRequest> m_MeshQueue;
+
+		std::atomic<size_t> m_MeshesPending = 0;
+
+		// world wide, mesh revisions never repeat across chunks at the same position
+		uint64_t m_NextMeshRevision = 0;
+
+		std::mutex m_MeshedMutex;
+		std::vector<ChunkMesh> m_Meshed;
+
+		// Recycled buffer that fits vertexHint vertices with the least spare room, or the largest one if none fits
+		std::vector<uint32_t> TakeMeshBuffer(int vertexHint);
+
+		// vertex buffers handed back by RecycleMesh, at most s_MaxMeshBuffers are kept
+		std::vector<std::vector<uint32_t>> m_MeshBuffers;
+		static constexpr size_t s_MaxMeshBuffers = 64;
+
+		// allocations of the meshes taken since the last Update, and how many meshes that was
+		size_t m_MeshAllocations = 0;
+		size_t m_MeshesTaken = 0;
+	};
+}
\ No newline at end of file
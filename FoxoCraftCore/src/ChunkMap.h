@@ -0,0 +1,216 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace FoxoCraft
+{
+	// Spatial hash for chunk coordinates
+	// The three axes are packed into 21 bits each and run through a splitmix64 finalizer,
+	// so permutations of the same coordinates and diagonal keys no longer collide
+	inline uint64_t HashChunkPos(glm::ivec3 cs)
+	{
+		constexpr uint64_t mask = (uint64_t(1) << 21) - 1;
+
+		uint64_t h = (static_cast<uint64_t>(static_cast<uint32_t>(cs.x)) & mask)
+			| ((static_cast<uint64_t>(static_cast<uint32_t>(cs.y)) & mask) << 21)
+			| ((static_cast<uint64_t>(static_cast<uint32_t>(cs.z)) & mask) << 42);
+
+		h ^= h >> 30;
+		h *= 0xbf58476d1ce4e5b9ull;
+		h ^= h >> 27;
+		h *= 0x94d049bb133111ebull;
+		h ^= h >> 31;
+		return h;
+	}
+
+	// Flat open addressing hash map keyed by chunk coordinates
+	// Keys and values are stored inline in a single power of two sized array and probed linearly
+	// Empty slots are marked with a sentinel key and erasing shifts the following entries back, so there are no tombstones
+	// Inserting or erasing invalidates pointers and iterators
+	template<typename T>
+	class ChunkMap final
+	{
+	public:
+		struct Slot
+		{
+			glm::ivec3 m_Key;
+			T m_Value;
+		};
+
+		template<typename SlotType>
+		class Iterator final
+		{
+		public:
+			Iterator(SlotType* ptr, SlotType* end)
+				: m_Ptr(ptr), m_End(end)
+			{
+				Skip();
+			}
+
+			SlotType& operator*() const { return *m_Ptr; }
+			SlotType* operator->() const { return m_Ptr; }
+
+			Iterator& operator++()
+			{
+				++m_Ptr;
+				Skip();
+				return *this;
+			}
+
+			bool operator==(const Iterator& other) const { return m_Ptr == other.m_Ptr; }
+			bool operator!=(const Iterator& other) const { return m_Ptr != other.m_Ptr; }
+		private:
+			void Skip()
+			{
+				while (m_Ptr != m_End && IsEmpty(m_Ptr->m_Key)) ++m_Ptr;
+			}
+
+			SlotType* m_Ptr;
+			SlotType* m_End;
+		};
+
+		using iterator = Iterator<Slot>;
+		using const_iterator = Iterator<const Slot>;
+
+		ChunkMap() = default;
+
+		T* Find(glm::ivec3 key)
+		{
+			if (m_Size == 0) return nullptr;
+
+			for (size_t i = HashChunkPos(key) & m_Mask;; i = (i + 1) & m_Mask)
+			{
+				Slot& slot = m_Slots[i];
+				if (slot.m_Key == key) return &slot.m_Value;
+				if (IsEmpty(slot.m_Key)) return nullptr;
+			}
+		}
+
+		const T* Find(glm::ivec3 key) const
+		{
+			return const_cast<ChunkMap*>(this)->Find(key);
+		}
+
+		bool Contains(glm::ivec3 key) const
+		{
+			return Find(key) != nullptr;
+		}
+
+		// Inserts or replaces the value stored at key
+		T& Insert(glm::ivec3 key, T value)
+		{
+			if ((m_Size + 1) * 4 > m_Slots.size() * 3)
+				Rehash(m_Slots.empty() ? 16 : m_Slots.size() * 2);
+
+			for (size_t i = HashChunkPos(key) & m_Mask;; i = (i + 1) & m_Mask)
+			{
+				Slot& slot = m_Slots[i];
+
+				if (slot.m_Key == key)
+				{
+					slot.m_Value = std::move(value);
+					return slot.m_Value;
+				}
+
+				if (IsEmpty(slot.m_Key))
+				{
+					slot.m_Key = key;
+					slot.m_Value = std::move(value);
+					++m_Size;
+					return slot.m_Value;
+				}
+			}
+		}
+
+		bool Erase(glm::ivec3 key)
+		{
+			if (m_Size == 0) return false;
+
+			size_t i = HashChunkPos(key) & m_Mask;
+
+			for (;; i = (i + 1) & m_Mask)
+			{
+				if (m_Slots[i].m_Key == key) break;
+				if (IsEmpty(m_Slots[i].m_Key)) return false;
+			}
+
+			// backward shift, pull later entries of the same probe chain into the hole
+			for (size_t j = (i + 1) & m_Mask;; j = (j + 1) & m_Mask)
+			{
+				if (IsEmpty(m_Slots[j].m_Key)) break;
+
+				size_t home = HashChunkPos(m_Slots[j].m_Key) & m_Mask;
+
+				// the entry at j may only move to i if i lies cyclically between its home and j
+				if (((j - home) & m_Mask) >= ((j - i) & m_Mask))
+				{
+					m_Slots[i] = std::move(m_Slots[j]);
+					i = j;
+				}
+			}
+
+			m_Slots[i].m_Key = s_EmptyKey;
+			m_Slots[i].m_Value = T();
+			--m_Size;
+			return true;
+		}
+
+		void Clear()
+		{
+			m_Slots.clear();
+			m_Mask = 0;
+			m_Size = 0;
+		}
+
+		void Reserve(size_t count)
+		{
+			size_t capacity = 16;
+			while (count * 4 > capacity * 3) capacity *= 2;
+			if (capacity > m_Slots.size()) Rehash(capacity);
+		}
+
+		size_t Size() const { return m_Size; }
+		bool Empty() const { return m_Size == 0; }
+		size_t Capacity() const { return m_Slots.size(); }
+
+		iterator begin() { return iterator(m_Slots.data(), m_Slots.data() + m_Slots.size()); }
+		iterator end() { return iterator(m_Slots.data() + m_Slots.size(), m_Slots.data() + m_Slots.size()); }
+		const_iterator begin() const { return const_iterator(m_Slots.data(), m_Slots.data() + m_Slots.size()); }
+		const_iterator end() const { return const_iterator(m_Slots.data() + m_Slots.size(), m_Slots.data() + m_Slots.size()); }
+	private:
+		static constexpr glm::ivec3 s_EmptyKey = glm::ivec3(std::numeric_limits<int>::min());
+
+		static bool IsEmpty(const glm::ivec3& key)
+		{
+			return key == s_EmptyKey;
+		}
+
+		void Rehash(size_t capacity)
+		{
+			// built in place so move only values work
+			std::vector<Slot> slots(capacity);
+			for (Slot& slot : slots) slot.m_Key = s_EmptyKey;
+
+			std::swap(slots, m_Slots);
+			m_Mask = capacity - 1;
+
+			for (Slot& slot : slots)
+			{
+				if (IsEmpty(slot.m_Key)) continue;
+
+				size_t i = HashChunkPos(slot.m_Key) & m_Mask;
+				while (!IsEmpty(m_Slots[i].m_Key)) i = (i + 1) & m_Mask;
+				m_Slots[i] = std::move(slot);
+			}
+		}
+
+		std::vector<Slot> m_Slots;
+		size_t m_Mask = 0;
+		size_t m_Size = 0;
+	};
+}
@@ -0,0 +1,450 @@
+#include "ChunkMesher.h"
+
+#include <array>
+#include <cstring>
+
+#include "Log.h"
+
+#ifdef _MSC_VER
+	#include <intrin.h>
+#endif
+
+namespace FoxoCraft
+{
+	void MeshScratch::Reserve(size_t capacity)
+	{
+		if (capacity <= m_Capacity) return;
+
+		std::unique_ptr<uint32_t[]> data(new uint32_t[capacity]);
+		if (m_Size) std::memcpy(data.get(), m_Data.get(), m_Size * sizeof(uint32_t));
+
+		m_Data = std::move(data);
+		m_Capacity = capacity;
+		++m_Allocations;
+	}
+
+	namespace Faces
+	{
+		static constexpr size_t s_NumFaces = 6;
+		static constexpr size_t s_NumVerts = 4;
+
+		// px py pz corner, corner is tx + ty * 2 of the vertex texture coordinate
+		// every face is drawn as the triangles 0 1 2 and 3 2 1, see s_QuadIndices
+		static constexpr uint8_t data[s_NumFaces][s_NumVerts][4] =
+		{
+			// left
+			{ { 0, 0, 0, 0 }, { 0, 0, 1, 1 }, { 0, 1, 0, 2 }, { 0, 1, 1, 3 } },
+			// right
+			{ { 1, 0, 1, 0 }, { 1, 0, 0, 1 }, { 1, 1, 1, 2 }, { 1, 1, 0, 3 } },
+			// bottom
+			{ { 0, 0, 0, 0 }, { 1, 0, 0, 1 }, { 0, 0, 1, 2 }, { 1, 0, 1, 3 } },
+			// top
+			{ { 0, 1, 1, 0 }, { 1, 1, 1, 1 }, { 0, 1, 0, 2 }, { 1, 1, 0, 3 } },
+			// back
+			{ { 1, 0, 0, 0 }, { 0, 0, 0, 1 }, { 1, 1, 0, 2 }, { 0, 1, 0, 3 } },
+			// front
+			{ { 0, 0, 1, 0 }, { 1, 0, 1, 1 }, { 0, 1, 1, 2 }, { 1, 1, 1, 3 } }
+		};
+
+		static constexpr uint32_t s_QuadIndices[6] = { 0, 1, 2, 3, 2, 1 };
+
+		// Packed vertex of every corner of a unit face at the chunk origin
+		// Each field of a packed vertex holds up to s_ChunkSize without carrying, a unit face anywhere is its cell's packed position plus these
+		static constexpr std::array<std::array<uint32_t, s_NumVerts>, s_NumFaces> BuildFaceCorners()
+		{
+			std::array<std::array<uint32_t, s_NumVerts>, s_NumFaces> corners = {};
+
+			for (uint32_t face = 0; face < s_NumFaces; ++face)
+			{
+				for (size_t i = 0; i < s_NumVerts; ++i)
+				{
+					const auto& vertex = data[face][i];
+					corners[face][i] = vertex[0] | (vertex[1] << 6) | (vertex[2] << 12) | (face << 18) | (vertex[3] << 21);
+				}
+			}
+
+			return corners;
+		}
+
+		static constexpr auto s_FaceCorners = BuildFaceCorners();
+
+		std::vector<uint32_t> BuildQuadIndices(size_t quadCount)
+		{
+			std::vector<uint32_t> indices;
+			indices.reserve(quadCount * 6);
+
+			for (size_t i = 0; i < quadCount; ++i)
+			{
+				for (uint32_t index : s_QuadIndices)
+					indices.push_back(static_cast<uint32_t>(i * s_NumVerts) + index);
+			}
+
+			return indices;
+		}
+
+		// Writes the vertices of a unit face, cell is PackVertex of its block with face and corner 0
+		static inline void WriteFace(uint32_t* quad, size_t faceIndex, uint32_t cell, uint32_t textureIndex)
+		{
+			for (size_t i = 0; i < s_NumVerts; ++i)
+			{
+				quad[i * 2] = cell + s_FaceCorners[faceIndex][i];
+				quad[i * 2 + 1] = textureIndex;
+			}
+		}
+
+		void AppendQuad(MeshScratch& scratch, size_t faceIndex, glm::ivec3 ls, glm::ivec3 size, uint32_t textureIndex, int& count)
+		{
+			uint32_t quad[s_QuadWords];
+
+			for (size_t i = 0; i < s_NumVerts; ++i)
+			{
+				const auto& vertex = Faces::data[faceIndex][i];
+				glm::ivec3 pos = ls + glm::ivec3(vertex[0] * size.x, vertex[1] * size.y, vertex[2] * size.z);
+
+				quad[i * 2] = PackVertex(pos, static_cast<uint32_t>(faceIndex), vertex[3]);
+				quad[i * 2 + 1] = textureIndex;
+			}
+
+			std::memcpy(scratch.Append(s_QuadWords), quad, sizeof(quad));
+			count += s_NumVerts;
+		}
+	}
+
+	static inline int CountTrailingZeros(uint32_t bits)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, bits);
+		return static_cast<int>(index);
+#else
+		return __builtin_ctz(bits);
+#endif
+	}
+
+	// Solid cells of a chunk and of the neighbor layers touching its sides, one bit per cell
+	// Rows run along x with cell x in bit x + 1 and the neighbors in bits 0 and 33, 34 bits so a row is a 64 bit word
+	// Rows are indexed by y and z from -1 to s_ChunkSize, rows outside on both y and z are never set or read
+	struct Occupancy
+	{
+		static constexpr int s_Padded = static_cast<int>(s_ChunkSize) + 2;
+
+		std::array<uint64_t, s_Padded * s_Padded> m_Rows;
+
+		// 32 bit rows straight from BlockStorage::GetOccupancy, indexed z * s_ChunkSize + y
+		std::array<uint32_t, s_ChunkSize2> m_Solid;
+
+		uint64_t& Row(int y, int z)
+		{
+			return m_Rows[(z + 1) * s_Padded + y + 1];
+		}
+
+		uint64_t Row(int y, int z) const
+		{
+			return m_Rows[(z + 1) * s_Padded + y + 1];
+		}
+
+		// Bit x set where cell x of the row is solid and its neighbor towards s_FaceDirections[i] is not
+		// x neighbors are the same row shifted by one cell
+		uint32_t Visible(size_t i, int y, int z) const
+		{
+			uint64_t row = Row(y, z);
+			uint32_t solid = static_cast<uint32_t>(row >> 1);
+
+			switch (i)
+			{
+			case 0: return solid & ~static_cast<uint32_t>(row);
+			case 1: return solid & ~static_cast<uint32_t>(row >> 2);
+			case 2: return solid & ~static_cast<uint32_t>(Row(y - 1, z) >> 1);
+			case 3: return solid & ~static_cast<uint32_t>(Row(y + 1, z) >> 1);
+			case 4: return solid & ~static_cast<uint32_t>(Row(y, z - 1) >> 1);
+			default: return solid & ~static_cast<uint32_t>(Row(y, z + 1) >> 1);
+			}
+		}
+
+		void Build(const ChunkSnapshot& snapshot)
+		{
+			constexpr int size = static_cast<int>(s_ChunkSize);
+
+			m_Rows.fill(0);
+			snapshot.m_Data->GetOccupancy(0, s_ChunkSize2, s_ChunkSize, m_Solid.data());
+
+			for (int z = 0; z < size; ++z)
+			{
+				for (int y = 0; y < size; ++y)
+					Row(y, z) = static_cast<uint64_t>(m_Solid[z * size + y]) << 1;
+			}
+
+			// the layer of each neighbor facing this chunk, unloaded neighbors stay air
+			for (size_t i = 0; i < 6; ++i)
+			{
+				const BlockStorage* neighbor = snapshot.m_Neighbors[i].get();
+				if (!neighbor) continue;
+
+				glm::ivec3 dir = glm::ivec3(s_FaceDirections[i]);
+				int axis = dir.x != 0 ? 0 : (dir.y != 0 ? 1 : 2);
+
+				// ls is the cell in the neighbor, padded the same cell seen from this chunk
+				glm::ivec3 ls = glm::ivec3(0);
+				ls[axis] = dir[axis] > 0 ? 0 : size - 1;
+				int padded = dir[axis] > 0 ? size : -1;
+
+				// z and y layers are rows along x, a z layer is contiguous and a y layer takes one row from every z
+				if (axis == 2)
+				{
+					neighbor->GetOccupancy(Chunk::IndexLS(ls), s_ChunkSize, s_ChunkSize, m_Solid.data());
+
+					for (int y = 0; y < size; ++y)
+						Row(y, padded) = static_cast<uint64_t>(m_Solid[y]) << 1;
+
+					continue;
+				}
+
+				if (axis == 1)
+				{
+					neighbor->GetOccupancy(Chunk::IndexLS(ls), s_ChunkSize, s_ChunkSize2, m_Solid.data());
+
+					for (int z = 0; z < size; ++z)
+						Row(padded, z) = static_cast<uint64_t>(m_Solid[z]) << 1;
+
+					continue;
+				}
+
+				// an x layer is one bit of every row, read cell by cell
+				bool uniform = neighbor->IsUniform();
+				bool solid = uniform && neighbor->Get(0);
+				if (uniform && !solid) continue;
+
+				uint64_t bit = uint64_t(1) << (padded + 1);
+
+				for (ls.z = 0; ls.z < size; ++ls.z)
+				{
+					for (ls.y = 0; ls.y < size; ++ls.y)
+					{
+						if (solid || neighbor->Get(Chunk::IndexLS(ls)))
+							Row(ls.y, ls.z) |= bit;
+					}
+				}
+			}
+		}
+	};
+
+	// Builds a mask of visible faces for every slice of every direction and merges equal cells into rectangles
+	static void BuildMeshGreedy(const ChunkSnapshot& snapshot, const Occupancy& occupancy, MeshScratch& scratch, ChunkMesh& mesh)
+	{
+		constexpr int size = static_cast<int>(s_ChunkSize);
+
+		const BlockStorage& data = *snapshot.m_Data;
+
+		// texture layer + 1 of the visible face in each cell of the slice, 0 where no face is visible
+		std::array<uint32_t, s_ChunkSize2> mask;
+		std::array<uint32_t, s_ChunkSize2> rows;
+
+		for (size_t i = 0; i < 6; ++i)
+		{
+			glm::ivec3 dir = glm::ivec3(s_FaceDirections[i]);
+			int axis = dir.x != 0 ? 0 : (dir.y != 0 ? 1 : 2);
+			int u = (axis + 1) % 3;
+			int v = (axis + 2) % 3;
+
+			// visible faces of every row, indexed z * s_ChunkSize + y
+			uint32_t any = 0;
+
+			for (int z = 0; z < size; ++z)
+			{
+				for (int y = 0; y < size; ++y)
+					any |= rows[z * size + y] = occupancy.Visible(i, y, z);
+			}
+
+			if (!any) continue;
+
+			glm::ivec3 ls;
+
+			for (ls[axis] = 0; ls[axis] < size; ++ls[axis])
+			{
+				bool visible = false;
+
+				for (ls[v] = 0; ls[v] < size; ++ls[v])
+				{
+					for (ls[u] = 0; ls[u] < size; ++ls[u])
+					{
+						uint32_t& cell = mask[ls[v] * size + ls[u]];
+						cell = 0;
+
+						if (!((rows[ls.z * size + ls.y] >> ls.x) & 1)) continue;
+
+						cell = GetBlockInfo(data.Get(Chunk::IndexLS(ls))).m_Textures[s_FaceDirections[i].w] + 1;
+						mesh.m_NaiveCount += Faces::s_NumVerts;
+						visible = true;
+					}
+				}
+
+				if (!visible) continue;
+
+				for (int y = 0; y < size; ++y)
+				{
+					for (int x = 0; x < size;)
+					{
+						uint32_t cell = mask[y * size + x];
+
+						if (!cell)
+						{
+							++x;
+							continue;
+						}
+
+						int w = 1;
+						while (x + w < size && mask[y * size + x + w] == cell) ++w;
+
+						int h = 1;
+						for (; y + h < size; ++h)
+						{
+							bool match = true;
+
+							for (int k = 0; k < w && match; ++k)
+								match = mask[(y + h) * size + x + k] == cell;
+
+							if (!match) break;
+						}
+
+						for (int dy = 0; dy < h; ++dy)
+						{
+							for (int dx = 0; dx < w; ++dx)
+								mask[(y + dy) * size + x + dx] = 0;
+						}
+
+						glm::ivec3 pos = ls;
+						pos[u] = x;
+						pos[v] = y;
+
+						glm::ivec3 extent = glm::ivec3(1, 1, 1);
+						extent[u] = w;
+						extent[v] = h;
+
+						Faces::AppendQuad(scratch, i, pos, extent, cell - 1, mesh.m_Count);
+
+						x += w;
+					}
+				}
+			}
+		}
+	}
+
+	// Vertex words of a row of 32 blocks with every face visible
+	static constexpr size_t s_MaxRowWords = 6 * s_ChunkSize * s_QuadWords;
+
+	// One quad per visible block face
+	// Every row yields a 32 bit mask of visible faces per direction, set bits are walked with ctz
+	static void BuildMeshNaive(const ChunkSnapshot& snapshot, const Occupancy& occupancy, MeshScratch& scratch, ChunkMesh& mesh)
+	{
+		constexpr int size = static_cast<int>(s_ChunkSize);
+
+		const BlockStorage& data = *snapshot.m_Data;
+
+		for (int z = 0; z < size; ++z)
+		{
+			for (int y = 0; y < size; ++y)
+			{
+				// bits 1 to 32 are this chunk's cells
+				if (!(occupancy.Row(y, z) & 0x1FFFFFFFEull)) continue;
+
+				uint32_t visible[6];
+				uint32_t any = 0;
+
+				for (size_t i = 0; i < 6; ++i)
+				{
+					visible[i] = occupancy.Visible(i, y, z);
+					any |= visible[i];
+				}
+
+				if (!any) continue;
+
+				// look each block up once however many of its faces show, neighbors in a row are mostly the same block
+				size_t rowIndex = Chunk::IndexLS(glm::ivec3(0, y, z));
+				const BlockInfo* infos[s_ChunkSize];
+				BlockId last = s_AirBlock;
+				const BlockInfo* info = nullptr;
+
+				for (uint32_t bits = any; bits; bits &= bits - 1)
+				{
+					int x = CountTrailingZeros(bits);
+					BlockId block = data.Get(rowIndex + x);
+
+					if (block != last)
+					{
+						last = block;
+						info = &GetBlockInfo(block);
+					}
+
+					infos[x] = info;
+				}
+
+				// room for every face a row can have, the faces are then written without a capacity check each
+				uint32_t* begin = scratch.Append(s_MaxRowWords);
+				uint32_t* quad = begin;
+				uint32_t rowCell = PackVertex(glm::ivec3(0, y, z), 0, 0);
+
+				for (size_t i = 0; i < 6; ++i)
+				{
+					for (uint32_t bits = visible[i]; bits; bits &= bits - 1)
+					{
+						int x = CountTrailingZeros(bits);
+						Faces::WriteFace(quad, i, rowCell + static_cast<uint32_t>(x), infos[x]->m_Textures[s_FaceDirections[i].w]);
+						quad += s_QuadWords;
+					}
+				}
+
+				size_t written = static_cast<size_t>(quad - begin);
+				scratch.m_Size -= s_MaxRowWords - written;
+				mesh.m_Count += static_cast<int>(written / s_QuadWords * Faces::s_NumVerts);
+			}
+		}
+	}
+
+	ChunkMesh BuildMeshV2(const ChunkSnapshot& snapshot, bool greedy, std::vector<uint32_t> vertices)
+	{
+		FC_PROFILE_SCOPE("Mesh chunk");
+
+		thread_local MeshScratch scratch;
+		scratch.m_Size = 0;
+		scratch.m_Allocations = 0;
+
+		ChunkMesh mesh;
+		mesh.m_Pos = snapshot.m_Pos;
+		mesh.m_Revision = snapshot.m_Revision;
+
+		const BlockStorage& data = *snapshot.m_Data;
+
+		// uniform air has nothing to mesh, the buffer still goes back so it is not lost to the pool
+		if (data.IsUniform() && !data.Get(0))
+		{
+			mesh.m_Vertices = std::move(vertices);
+			mesh.m_Vertices.clear();
+			return mesh;
+		}
+
+		// sized from the last mesh of the chunk so a first mesh does not grow the scratch face by face
+		// the naive mesher appends room for a whole row before trimming it, so a remesh of the same size must not grow either
+		scratch.Reserve(static_cast<size_t>(snapshot.m_VertexHint) / Faces::s_NumVerts * s_QuadWords + s_MaxRowWords);
+
+		// 13 KiB, kept off the workers' stacks
+		thread_local Occupancy occupancy;
+		occupancy.Build(snapshot);
+
+		if (greedy)
+		{
+			BuildMeshGreedy(snapshot, occupancy, scratch, mesh);
+		}
+		else
+		{
+			BuildMeshNaive(snapshot, occupancy, scratch, mesh);
+			mesh.m_NaiveCount = mesh.m_Count;
+		}
+
+		mesh.m_Allocations = scratch.m_Allocations;
+		if (vertices.capacity() < scratch.m_Size) ++mesh.m_Allocations;
+
+		mesh.m_Vertices = std::move(vertices);
+		mesh.m_Vertices.assign(scratch.m_Data.get(), scratch.m_Data.get() + scratch.m_Size);
+		return mesh;
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Chunk.h"
+
+namespace FoxoCraft
+{
+	// Chunk vertices are two packed uint32s, decoded in chunk.vert
+	// x: chunk local position 6 bits per axis, face index in bits 18-20, quad corner in bits 21-22
+	// y: texture layer
+	// Texture coordinates are derived from the position and face in the shader so greedy quads repeat their texture
+	inline constexpr size_t s_VertexSize = 2 * sizeof(uint32_t);
+
+	inline uint32_t PackVertex(glm::ivec3 ls, uint32_t face, uint32_t corner)
+	{
+		return static_cast<uint32_t>(ls.x) | (static_cast<uint32_t>(ls.y) << 6) | (static_cast<uint32_t>(ls.z) << 12) | (face << 18) | (corner << 21);
+	}
+
+	// Upper bound of quads in one chunk mesh, a checkerboard of blocks with every face visible
+	inline constexpr size_t s_MaxChunkQuads = s_ChunkSize3 / 2 * 6;
+
+	// Vertex words of one quad, 4 vertices of 2 words
+	inline constexpr size_t s_QuadWords = 8;
+
+	// Vertex output of the mesher, one per thread, keeps its capacity so meshing stops allocating once it has seen the largest mesh
+	struct MeshScratch
+	{
+		std::unique_ptr<uint32_t[]> m_Data;
+		size_t m_Capacity = 0;
+		size_t m_Size = 0;
+
+		// times m_Data grew since the count was last reset
+		int m_Allocations = 0;
+
+		// Grows m_Data to hold at least capacity words, keeping its contents
+		void Reserve(size_t capacity);
+
+		// Room for words more words at the end, the only capacity check a face needs
+		uint32_t* Append(size_t words)
+		{
+			if (m_Size + words > m_Capacity) Reserve(std::max(m_Capacity * 2, m_Size + words));
+
+			uint32_t* data = m_Data.get() + m_Size;
+			m_Size += words;
+			return data;
+		}
+	};
+
+	namespace Faces
+	{
+		// Meshes store 4 vertices per quad, the triangles come from one index buffer shared by every chunk
+		std::vector<uint32_t> BuildQuadIndices(size_t quadCount);
+
+		// Appends a face stretched to size blocks, the texture repeats once per block
+		// Positions are chunk local, 0 to s_ChunkSize inclusive
+		void AppendQuad(MeshScratch& scratch, size_t faceIndex, glm::ivec3 ls, glm::ivec3 size, uint32_t textureIndex, int& count);
+	};
+
+	// Builds the vertex data of a chunk from a snapshot, touches no shared state and is safe to call from any thread
+	// Greedy meshing merges coplanar faces sharing a texture into larger quads
+	// Both find visible faces from one solid bit per block, compared a 32 block row at a time
+	// The mesh is built in a thread local MeshScratch and copied into vertices, pass a recycled buffer to reuse its capacity
+	ChunkMesh BuildMeshV2(const ChunkSnapshot& snapshot, bool greedy = false, std::vector<uint32_t> vertices = {});
+}
@@ -0,0 +1,98 @@
+#include "ChunkSaver.h"
+
+#include "Log.h"
+
+namespace FoxoCraft
+{
+	ChunkSaver::ChunkSaver(WorldStorage& storage, size_t capacity)
+		: m_Storage(storage), m_Capacity(capacity)
+	{
+		m_Thread = std::thread(&ChunkSaver::ThreadMain, this);
+	}
+
+	ChunkSaver::~ChunkSaver()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Running = false;
+		}
+
+		// the thread drains the queue before it exits
+		m_Wake.notify_one();
+		m_Thread.join();
+	}
+
+	bool ChunkSaver::Queue(glm::ivec3 cs, std::shared_ptr<const BlockStorage> data)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			if (std::shared_ptr<const BlockStorage>* pending = m_Pending.Find(cs))
+			{
+				// the saver thread requeues the chunk if it is being written right now
+				*pending = std::move(data);
+				return true;
+			}
+
+			if (m_Pending.Size() >= m_Capacity) return false;
+
+			m_Pending.Insert(cs, std::move(data));
+			m_Order.push_back(cs);
+		}
+
+		m_Wake.notify_one();
+		return true;
+	}
+
+	std::shared_ptr<const BlockStorage> ChunkSaver::Find(glm::ivec3 cs)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		std::shared_ptr<const BlockStorage>* pending = m_Pending.Find(cs);
+		return pending ? *pending : nullptr;
+	}
+
+	void ChunkSaver::Flush()
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Idle.wait(lock, [this]() { return m_Order.empty() && !m_Writing; });
+	}
+
+	size_t ChunkSaver::GetQueueDepth()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Pending.Size();
+	}
+
+	void ChunkSaver::ThreadMain()
+	{
+		Profiler::SetThreadName("Chunk saver");
+
+		std::unique_lock<std::mutex> lock(m_Mutex);
+
+		while (true)
+		{
+			m_Wake.wait(lock, [this]() { return !m_Order.empty() || !m_Running; });
+			if (m_Order.empty()) break;
+
+			glm::ivec3 cs = m_Order.front();
+			m_Order.pop_front();
+
+			std::shared_ptr<const BlockStorage> data = *m_Pending.Find(cs);
+			m_Writing = true;
+
+			lock.unlock();
+			m_Storage.SaveChunk(cs, *data);
+			lock.lock();
+
+			// replaced while it was written, the newer storage goes to the back of the queue
+			if (*m_Pending.Find(cs) == data)
+				m_Pending.Erase(cs);
+			else
+				m_Order.push_back(cs);
+
+			m_Writing = false;
+			if (m_Order.empty()) m_Idle.notify_all();
+		}
+	}
+}
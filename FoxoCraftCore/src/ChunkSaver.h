@@ -0,0 +1,63 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <glm/glm.hpp>
+
+#include "BlockStorage.h"
+#include "ChunkMap.h"
+#include "WorldStorage.h"
+
+namespace FoxoCraft
+{
+	// Writes chunks to a WorldStorage on its own thread so saving never waits on the disk
+	// Chunks are queued as copy on write block storage, the chunk keeps being edited while the write is pending
+	// A chunk queued again before it was written only has its storage replaced, it is still written once
+	class ChunkSaver final
+	{
+	public:
+		// capacity is the number of distinct chunks that may wait to be written
+		ChunkSaver(WorldStorage& storage, size_t capacity = 256);
+
+		// Writes everything still queued
+		~ChunkSaver();
+
+		ChunkSaver(const ChunkSaver&) = delete;
+		ChunkSaver& operator=(const ChunkSaver&) = delete;
+
+		// Returns false if the queue is full and the chunk is not queued yet, never blocks on the disk
+		bool Queue(glm::ivec3 cs, std::shared_ptr<const BlockStorage> data);
+
+		// Latest storage queued for a chunk that is not written yet, null otherwise
+		// Loads have to check this first, the region file may still hold an older version
+		std::shared_ptr<const BlockStorage> Find(glm::ivec3 cs);
+
+		// Blocks until every queued chunk is written
+		void Flush();
+
+		size_t GetQueueDepth();
+		size_t GetCapacity() const { return m_Capacity; }
+	private:
+		void ThreadMain();
+
+		WorldStorage& m_Storage;
+		size_t m_Capacity;
+
+		std::mutex m_Mutex;
+		std::condition_variable m_Wake;
+		std::condition_variable m_Idle;
+
+		// queued chunks stay in m_Pending until their write finished, m_Order holds the ones not picked up yet
+		ChunkMap<std::shared_ptr<const BlockStorage>> m_Pending;
+		std::deque<glm::ivec3> m_Order;
+		bool m_Writing = false;
+		bool m_Running = true;
+
+		std::thread m_Thread;
+	};
+}
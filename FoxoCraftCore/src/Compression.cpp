@@ -0,0 +1,138 @@
+#include "Compression.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace FoxoCraft
+{
+	namespace Compression
+	{
+		static constexpr size_t s_MinMatch = 4;
+		static constexpr size_t s_MaxOffset = 65535;
+		static constexpr uint32_t s_HashBits = 12;
+
+		static uint32_t Read32(const uint8_t* ptr)
+		{
+			uint32_t value;
+			std::memcpy(&value, ptr, sizeof(value));
+			return value;
+		}
+
+		static uint32_t Hash(uint32_t value)
+		{
+			return (value * 2654435761u) >> (32 - s_HashBits);
+		}
+
+		static void WriteLength(std::vector<uint8_t>& out, size_t length)
+		{
+			for (; length >= 255; length -= 255)
+				out.push_back(255);
+
+			out.push_back(static_cast<uint8_t>(length));
+		}
+
+		static void WriteSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalLength, size_t offset, size_t matchLength)
+		{
+			size_t matchCode = matchLength ? matchLength - s_MinMatch : 0;
+
+			out.push_back(static_cast<uint8_t>((literalLength < 15 ? literalLength : 15) << 4 | (matchCode < 15 ? matchCode : 15)));
+			if (literalLength >= 15) WriteLength(out, literalLength - 15);
+
+			out.insert(out.end(), literals, literals + literalLength);
+
+			if (matchLength == 0) return;
+
+			out.push_back(static_cast<uint8_t>(offset));
+			out.push_back(static_cast<uint8_t>(offset >> 8));
+			if (matchCode >= 15) WriteLength(out, matchCode - 15);
+		}
+
+		void Compress(const uint8_t* data, size_t size, std::vector<uint8_t>& out)
+		{
+			// positions of the last occurrence of every hashed 4 byte sequence, offset by one so 0 means none
+			uint32_t table[1 << s_HashBits] = {};
+
+			size_t anchor = 0;
+			size_t i = 0;
+
+			while (i + s_MinMatch <= size)
+			{
+				uint32_t value = Read32(data + i);
+				uint32_t& entry = table[Hash(value)];
+				size_t candidate = entry;
+				entry = static_cast<uint32_t>(i + 1);
+
+				if (candidate == 0 || i + 1 - candidate > s_MaxOffset || Read32(data + candidate - 1) != value)
+				{
+					++i;
+					continue;
+				}
+
+				size_t match = candidate - 1;
+				size_t length = s_MinMatch;
+				while (i + length < size && data[match + length] == data[i + length]) ++length;
+
+				WriteSequence(out, data + anchor, i - anchor, i - match, length);
+
+				i += length;
+				anchor = i;
+			}
+
+			WriteSequence(out, data + anchor, size - anchor, 0, 0);
+		}
+
+		static bool ReadLength(const uint8_t*& ip, const uint8_t* end, size_t& length)
+		{
+			uint8_t byte;
+
+			do
+			{
+				if (ip == end) return false;
+				byte = *ip++;
+				length += byte;
+			}
+			while (byte == 255);
+
+			return true;
+		}
+
+		bool Decompress(const uint8_t* data, size_t dataSize, uint8_t* out, size_t size)
+		{
+			const uint8_t* ip = data;
+			const uint8_t* end = data + dataSize;
+			size_t op = 0;
+
+			while (ip != end)
+			{
+				uint8_t token = *ip++;
+
+				size_t literalLength = token >> 4;
+				if (literalLength == 15 && !ReadLength(ip, end, literalLength)) return false;
+
+				if (literalLength > static_cast<size_t>(end - ip) || literalLength > size - op) return false;
+				std::copy(ip, ip + literalLength, out + op);
+				ip += literalLength;
+				op += literalLength;
+
+				// the last sequence has no match
+				if (ip == end) break;
+
+				if (end - ip < 2) return false;
+				size_t offset = ip[0] | (ip[1] << 8);
+				ip += 2;
+
+				size_t matchLength = token & 15;
+				if (matchLength == 15 && !ReadLength(ip, end, matchLength)) return false;
+				matchLength += s_MinMatch;
+
+				if (offset == 0 || offset > op || matchLength > size - op) return false;
+
+				// matches may overlap their own output, copy byte by byte
+				for (size_t i = 0; i < matchLength; ++i, ++op)
+					out[op] = out[op - offset];
+			}
+
+			return op == size;
+		}
+	}
+}
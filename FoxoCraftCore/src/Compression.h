@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace FoxoCraft
+{
+	// Byte oriented LZ77 compressor in the spirit of the LZ4 block format
+	// A stream is a list of sequences: a token with a 4 bit literal length and 4 bit match length,
+	// the literals, then a 16 bit match offset. Lengths of 15 continue in following bytes that are added up until one is below 255
+	// The last sequence only holds literals
+	namespace Compression
+	{
+		// Appends the compressed form of data to out
+		void Compress(const uint8_t* data, size_t size, std::vector<uint8_t>& out);
+
+		// Decompresses exactly size bytes into out, returns false if the stream is malformed or does not decode to size bytes
+		bool Decompress(const uint8_t* data, size_t dataSize, uint8_t* out, size_t size);
+	}
+}
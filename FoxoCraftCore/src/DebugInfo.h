@@ -0,0 +1,60 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// Rolling timings of one pass in milliseconds
+struct TimingStats
+{
+	double m_Min = 0.0;
+	double m_Avg = 0.0;
+	double m_P99 = 0.0;
+};
+
+// Statistics the world and the renderer fill in every frame, and the settings the debug window edits
+// Draw needs ImGui and is part of the game, not the core library
+struct DebugData
+{
+	size_t chunksRendered;
+	size_t chunksTotal;
+	size_t chunksMemory;
+	size_t chunksUniform;
+	double generationTime;
+	double loadTime;
+	size_t chunksLoaded;
+	size_t chunksSaved;
+	size_t bytesWritten;
+	size_t saveQueue;
+	size_t saveQueueCapacity;
+	size_t heightmapsCached;
+	size_t heightmapHits;
+	size_t heightmapMisses;
+	size_t meshesPending;
+	size_t meshQueue;
+	size_t meshAllocations;
+	size_t meshesTaken;
+	double meshScheduleTime;
+	size_t uploadsQueued;
+	double uploadTime;
+	size_t vertices;
+	size_t verticesNaive;
+	size_t vertexBytes;
+	size_t indexBytes;
+	size_t arenaUsed;
+	size_t arenaCapacity;
+	size_t arenaFreeBlocks;
+	size_t chunksLoading;
+	size_t chunksUnloaded;
+	glm::vec3 playerPos;
+
+	// gpu time of the render passes, measured by the game's GpuTimers
+	TimingStats gpuClear;
+	TimingStats gpuChunks;
+	TimingStats gpuImGui;
+
+	bool enableWireframe = false;
+	bool enableGreedyMeshing = false;
+	bool showProfiler = false;
+	int viewRadius = 6;
+
+	void Draw();
+};
\ No newline at end of file
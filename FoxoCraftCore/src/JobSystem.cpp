@@ -0,0 +1,163 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <string>
+
+#include "Log.h"
+
+namespace FoxoCraft
+{
+	static thread_local const JobSystem* s_WorkerOwner = nullptr;
+	static thread_local int s_WorkerIndex = -1;
+
+	JobSystem::JobSystem(size_t threadCount)
+	{
+		if (threadCount == 0)
+			threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+		m_Workers.reserve(threadCount);
+
+		for (size_t i = 0; i < threadCount; ++i)
+			m_Workers.push_back(std::make_unique<Worker>());
+
+		// start threads only once every deque exists, workers steal from each other immediately
+		for (size_t i = 0; i < threadCount; ++i)
+			m_Workers[i]->m_Thread = std::thread(&JobSystem::WorkerMain, this, i);
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_WakeMutex);
+			m_Running = false;
+		}
+
+		m_Wake.notify_all();
+
+		for (auto& worker : m_Workers)
+			worker->m_Thread.join();
+	}
+
+	void JobSystem::Submit(Job job)
+	{
+		++m_Pending;
+
+		{
+			// counted under the wake mutex so a worker about to sleep cannot miss it
+			// and before the job is published, a thief that takes it right away must not decrement below zero
+			std::lock_guard<std::mutex> lock(m_WakeMutex);
+			++m_Queued;
+		}
+
+		if (s_WorkerOwner == this)
+		{
+			Worker& self = *m_Workers[s_WorkerIndex];
+			std::lock_guard<std::mutex> lock(self.m_Mutex);
+			self.m_Jobs.push_back(std::move(job));
+		}
+		else
+		{
+			std::lock_guard<std::mutex> lock(m_ExternalMutex);
+			m_External.push_back(std::move(job));
+		}
+
+		m_Wake.notify_one();
+	}
+
+	void JobSystem::Wait()
+	{
+		std::unique_lock<std::mutex> lock(m_IdleMutex);
+		m_Idle.wait(lock, [this]() { return m_Pending == 0; });
+	}
+
+	size_t JobSystem::GetThreadCount() const
+	{
+		return m_Workers.size();
+	}
+
+	size_t JobSystem::GetPendingCount() const
+	{
+		return m_Pending;
+	}
+
+	int JobSystem::GetWorkerIndex()
+	{
+		return s_WorkerOwner ? s_WorkerIndex : -1;
+	}
+
+	void JobSystem::WorkerMain(size_t index)
+	{
+		s_WorkerOwner = this;
+		s_WorkerIndex = static_cast<int>(index);
+
+		Profiler::SetThreadName("Worker " + std::to_string(index));
+
+		for (;;)
+		{
+			Job job;
+
+			if (TryPop(index, job))
+			{
+				job();
+
+				if (--m_Pending == 0)
+				{
+					std::lock_guard<std::mutex> lock(m_IdleMutex);
+					m_Idle.notify_all();
+				}
+
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m_WakeMutex);
+			m_Wake.wait(lock, [this]() { return m_Queued > 0 || !m_Running; });
+
+			if (!m_Running && m_Queued == 0) return;
+		}
+	}
+
+	bool JobSystem::TryPop(size_t index, Job& job)
+	{
+		{
+			Worker& self = *m_Workers[index];
+			std::lock_guard<std::mutex> lock(self.m_Mutex);
+
+			if (!self.m_Jobs.empty())
+			{
+				job = std::move(self.m_Jobs.back());
+				self.m_Jobs.pop_back();
+				--m_Queued;
+				return true;
+			}
+		}
+
+		// first in first out, popping these from the back would run the lowest priority job of every batch first
+		{
+			std::lock_guard<std::mutex> lock(m_ExternalMutex);
+
+			if (!m_External.empty())
+			{
+				job = std::move(m_External.front());
+				m_External.pop_front();
+				--m_Queued;
+				return true;
+			}
+		}
+
+		for (size_t i = 1; i < m_Workers.size(); ++i)
+		{
+			Worker& victim = *m_Workers[(index + i) % m_Workers.size()];
+			std::lock_guard<std::mutex> lock(victim.m_Mutex);
+
+			if (!victim.m_Jobs.empty())
+			{
+				job = std::move(victim.m_Jobs.front());
+				victim.m_Jobs.pop_front();
+				--m_Queued;
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
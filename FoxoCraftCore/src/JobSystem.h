@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace FoxoCraft
+{
+	// Work stealing thread pool
+	// Every worker owns a deque, it pops its own jobs from the back and steals from the front of the others when it runs dry
+	// Jobs submitted from a worker go to that worker's deque, jobs from any other thread go to one shared queue
+	// that workers take from in submission order once their own deque is empty, so callers can submit in priority order
+	class JobSystem final
+	{
+	public:
+		using Job = std::function<void()>;
+
+		// A thread count of 0 uses one worker per hardware thread
+		JobSystem(size_t threadCount = 0);
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		void Submit(Job job);
+
+		// Blocks until every submitted job has finished
+		void Wait();
+
+		size_t GetThreadCount() const;
+
+		// Jobs submitted but not yet finished
+		size_t GetPendingCount() const;
+
+		// Index of the calling worker, -1 when called from a thread outside the pool
+		static int GetWorkerIndex();
+	private:
+		struct Worker
+		{
+			std::mutex m_Mutex;
+			std::deque<Job> m_Jobs;
+			std::thread m_Thread;
+		};
+
+		void WorkerMain(size_t index);
+		bool TryPop(size_t index, Job& job);
+	private:
+		std::vector<std::unique_ptr<Worker>> m_Workers;
+
+		std::mutex m_ExternalMutex;
+		std::deque<Job> m_External;
+
+		std::atomic<size_t> m_Pending = 0;
+		std::atomic<size_t> m_Queued = 0;
+
+		std::mutex m_WakeMutex;
+		std::condition_variable m_Wake;
+		bool m_Running = true;
+
+		std::mutex m_IdleMutex;
+		std::condition_variable m_Idle;
+	};
+}
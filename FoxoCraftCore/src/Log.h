@@ -0,0 +1,18 @@
+#pragma once
+
+#include <spdlog/spdlog.h>
+
+#include "Profiler.h"
+
+#define FC_LOG_TRACE(...) ::spdlog::trace(__VA_ARGS__)
+#define FC_LOG_DEBUG(...) ::spdlog::debug(__VA_ARGS__)
+#define FC_LOG_INFO(...) ::spdlog::info(__VA_ARGS__)
+#define FC_LOG_WARN(...) ::spdlog::warn(__VA_ARGS__)
+#define FC_LOG_ERROR(...) ::spdlog::error(__VA_ARGS__)
+#define FC_LOG_CRITICAL(...) ::spdlog::critical(__VA_ARGS__)
+
+#define FC_PROFILE_CONCAT_INNER(a, b) a##b
+#define FC_PROFILE_CONCAT(a, b) FC_PROFILE_CONCAT_INNER(a, b)
+
+// Times the rest of the enclosing scope as a zone in the profiler, name must be a string literal
+#define FC_PROFILE_SCOPE(name) ::FoxoCraft::ProfileScope FC_PROFILE_CONCAT(fc_ProfileScope, __LINE__)(name)
\ No newline at end of file
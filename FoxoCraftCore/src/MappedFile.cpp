@@ -0,0 +1,103 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#include "Log.h"
+
+namespace FoxoCraft
+{
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+#ifdef _WIN32
+	bool MappedFile::Open(const std::filesystem::path& path)
+	{
+		Close();
+
+		// region files are written while they are mapped, allow other handles to write and replace the file
+		m_File = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+		LARGE_INTEGER size;
+		if (m_File == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_File, &size) || size.QuadPart == 0)
+		{
+			FC_LOG_ERROR("Failed to open {} for mapping", path.u8string());
+			Close();
+			return false;
+		}
+
+		m_Mapping = CreateFileMappingW(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (m_Mapping) m_Data = static_cast<const uint8_t*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+
+		if (!m_Data)
+		{
+			FC_LOG_ERROR("Failed to map {}", path.u8string());
+			Close();
+			return false;
+		}
+
+		m_Size = static_cast<size_t>(size.QuadPart);
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (m_Data) UnmapViewOfFile(m_Data);
+		if (m_Mapping) CloseHandle(m_Mapping);
+		if (m_File && m_File != INVALID_HANDLE_VALUE) CloseHandle(m_File);
+
+		m_Data = nullptr;
+		m_Size = 0;
+		m_Mapping = nullptr;
+		m_File = nullptr;
+	}
+#else
+	bool MappedFile::Open(const std::filesystem::path& path)
+	{
+		Close();
+
+		int fd = open(path.c_str(), O_RDONLY);
+
+		struct stat info;
+		if (fd < 0 || fstat(fd, &info) != 0 || info.st_size == 0)
+		{
+			FC_LOG_ERROR("Failed to open {} for mapping", path.u8string());
+			if (fd >= 0) close(fd);
+			return false;
+		}
+
+		void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+
+		// the mapping keeps its own reference to the file
+		close(fd);
+
+		if (data == MAP_FAILED)
+		{
+			FC_LOG_ERROR("Failed to map {}", path.u8string());
+			return false;
+		}
+
+		m_Data = static_cast<const uint8_t*>(data);
+		m_Size = static_cast<size_t>(info.st_size);
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (m_Data) munmap(const_cast<uint8_t*>(m_Data), m_Size);
+
+		m_Data = nullptr;
+		m_Size = 0;
+	}
+#endif
+}
@@ -0,0 +1,274 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+#include "Log.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+	#ifdef _MSC_VER
+		#include <intrin.h>
+	#else
+		#include <x86intrin.h>
+	#endif
+
+	#define FC_PROFILER_TSC
+#endif
+
+namespace FoxoCraft
+{
+	namespace
+	{
+		// Zones store raw ticks, on x86 the time stamp counter which costs a fraction of a steady_clock read
+		// Ticks are converted to nanoseconds when zones are read, against steady_clock over the whole run
+		inline uint64_t ReadTicks()
+		{
+#ifdef FC_PROFILER_TSC
+			return __rdtsc();
+#else
+			return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+		}
+
+		// fields are relaxed atomics so a reader racing the writer of the oldest slot reads stale values instead of undefined behavior
+		// on x86 and arm64 these are plain loads and stores
+		struct Zone
+		{
+			std::atomic<const char*> m_Name = nullptr;
+			std::atomic<uint64_t> m_Start = 0;
+			std::atomic<uint64_t> m_End = 0;
+			std::atomic<uint32_t> m_Depth = 0;
+		};
+
+		struct ThreadBuffer
+		{
+			std::array<Zone, Profiler::s_ThreadCapacity> m_Zones;
+
+			// zones ever written, the zone at m_Head - 1 is the newest, published with release
+			std::atomic<uint64_t> m_Head = 0;
+
+			// owning thread only
+			uint32_t m_Depth = 0;
+
+			// guarded by s_ThreadsMutex
+			std::string m_Name;
+		};
+
+		static_assert((Profiler::s_ThreadCapacity & (Profiler::s_ThreadCapacity - 1)) == 0, "Ring buffer capacity must be a power of two");
+
+		const std::chrono::steady_clock::time_point s_Epoch = std::chrono::steady_clock::now();
+		const uint64_t s_EpochTicks = ReadTicks();
+
+		// Nanoseconds per tick, the counter rate is measured again on every call so it gets more precise the longer the game runs
+		double GetTickScale()
+		{
+#ifdef FC_PROFILER_TSC
+			double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - s_Epoch).count();
+			double elapsedTicks = static_cast<double>(ReadTicks() - s_EpochTicks);
+			return elapsedTicks > 0.0 ? elapsed / elapsedTicks : 0.0;
+#else
+			return 1.0;
+#endif
+		}
+
+		uint64_t ToNanoseconds(uint64_t ticks, double scale)
+		{
+			return ticks > s_EpochTicks ? static_cast<uint64_t>((ticks - s_EpochTicks) * scale) : 0;
+		}
+
+		std::mutex s_ThreadsMutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> s_Threads;
+
+		thread_local ThreadBuffer* s_Thread = nullptr;
+
+		// ticks, main thread only
+		uint64_t s_FrameStart = 0;
+		uint64_t s_LastFrameStart = 0;
+		size_t s_Frames = 0;
+
+		ThreadBuffer& GetThreadBuffer()
+		{
+			if (s_Thread) return *s_Thread;
+
+			std::lock_guard<std::mutex> lock(s_ThreadsMutex);
+
+			s_Threads.push_back(std::make_unique<ThreadBuffer>());
+			s_Thread = s_Threads.back().get();
+			s_Thread->m_Name = "Thread " + std::to_string(s_Threads.size() - 1);
+
+			return *s_Thread;
+		}
+
+		// Copies the zones of one buffer, skipping any the owner may have overwritten while they were copied
+		void CopyZones(const ThreadBuffer& buffer, uint32_t thread, double scale, uint64_t begin, uint64_t end, std::vector<Profiler::Event>& events)
+		{
+			uint64_t head = buffer.m_Head.load(std::memory_order_acquire);
+			uint64_t first = head > Profiler::s_ThreadCapacity ? head - Profiler::s_ThreadCapacity : 0;
+
+			size_t count = events.size();
+			std::vector<uint64_t> indices;
+
+			for (uint64_t i = first; i < head; ++i)
+			{
+				const Zone& zone = buffer.m_Zones[i & (Profiler::s_ThreadCapacity - 1)];
+
+				Profiler::Event event;
+				event.m_Name = zone.m_Name.load(std::memory_order_relaxed);
+				event.m_Start = ToNanoseconds(zone.m_Start.load(std::memory_order_relaxed), scale);
+				event.m_End = ToNanoseconds(zone.m_End.load(std::memory_order_relaxed), scale);
+				event.m_Thread = thread;
+				event.m_Depth = zone.m_Depth.load(std::memory_order_relaxed);
+
+				if (event.m_End < begin || event.m_Start >= end) continue;
+
+				events.push_back(event);
+				indices.push_back(i);
+			}
+
+			// like a seqlock, zones at or past the slot the owner is writing now are torn and dropped
+			std::atomic_thread_fence(std::memory_order_acquire);
+			uint64_t newHead = buffer.m_Head.load(std::memory_order_relaxed);
+			if (newHead < Profiler::s_ThreadCapacity) return;
+
+			uint64_t valid = newHead - Profiler::s_ThreadCapacity + 1;
+			size_t torn = std::lower_bound(indices.begin(), indices.end(), valid) - indices.begin();
+
+			events.erase(events.begin() + count, events.begin() + count + torn);
+		}
+
+		void WriteEscaped(std::ofstream& file, const char* text)
+		{
+			for (; *text; ++text)
+			{
+				if (*text == '"' || *text == '\\') file << '\\';
+				file << *text;
+			}
+		}
+	}
+
+	uint64_t Profiler::Now()
+	{
+		return ToNanoseconds(ReadTicks(), GetTickScale());
+	}
+
+	void Profiler::SetThreadName(const std::string& name)
+	{
+		ThreadBuffer& buffer = GetThreadBuffer();
+
+		std::lock_guard<std::mutex> lock(s_ThreadsMutex);
+		buffer.m_Name = name;
+	}
+
+	void Profiler::BeginFrame()
+	{
+		s_LastFrameStart = s_FrameStart;
+		s_FrameStart = ReadTicks();
+		++s_Frames;
+	}
+
+	bool Profiler::GetLastFrame(uint64_t& begin, uint64_t& end)
+	{
+		if (s_Frames < 2) return false;
+
+		double scale = GetTickScale();
+		begin = ToNanoseconds(s_LastFrameStart, scale);
+		end = ToNanoseconds(s_FrameStart, scale);
+		return true;
+	}
+
+	void Profiler::Collect(uint64_t begin, uint64_t end, std::vector<Event>& events)
+	{
+		double scale = GetTickScale();
+
+		std::lock_guard<std::mutex> lock(s_ThreadsMutex);
+
+		for (size_t i = 0; i < s_Threads.size(); ++i)
+			CopyZones(*s_Threads[i], static_cast<uint32_t>(i), scale, begin, end, events);
+	}
+
+	std::vector<std::string> Profiler::GetThreadNames()
+	{
+		std::lock_guard<std::mutex> lock(s_ThreadsMutex);
+
+		std::vector<std::string> names;
+		for (auto& buffer : s_Threads)
+			names.push_back(buffer->m_Name);
+
+		return names;
+	}
+
+	bool Profiler::ExportChromeTrace(const std::filesystem::path& path)
+	{
+		std::vector<Event> events;
+		Collect(0, UINT64_MAX, events);
+
+		std::vector<std::string> names = GetThreadNames();
+
+		std::ofstream file(path, std::ios::trunc);
+		file << "{\"traceEvents\":[\n";
+
+		for (size_t i = 0; i < names.size(); ++i)
+		{
+			file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << i << ",\"args\":{\"name\":\"";
+			WriteEscaped(file, names[i].c_str());
+			file << "\"}},\n";
+		}
+
+		// timestamps and durations are microseconds
+		char buffer[64];
+
+		for (const Event& event : events)
+		{
+			file << "{\"name\":\"";
+			WriteEscaped(file, event.m_Name);
+			std::snprintf(buffer, sizeof(buffer), "%.3f", event.m_Start / 1000.0);
+			file << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.m_Thread << ",\"ts\":" << buffer;
+			std::snprintf(buffer, sizeof(buffer), "%.3f", (event.m_End - event.m_Start) / 1000.0);
+			file << ",\"dur\":" << buffer << "},\n";
+		}
+
+		// the trailing comma of the last event is not valid JSON, end with an empty metadata event
+		file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"FoxoCraft\"}}\n]}\n";
+
+		if (!file)
+		{
+			FC_LOG_ERROR("Failed to write trace {}", path.u8string());
+			return false;
+		}
+
+		FC_LOG_INFO("Wrote {} zones to {}", events.size(), path.u8string());
+		return true;
+	}
+
+	ProfileScope::ProfileScope(const char* name)
+		: m_Name(name)
+	{
+		++GetThreadBuffer().m_Depth;
+		m_Start = ReadTicks();
+	}
+
+	ProfileScope::~ProfileScope()
+	{
+		uint64_t end = ReadTicks();
+
+		ThreadBuffer& buffer = *s_Thread;
+		uint64_t head = buffer.m_Head.load(std::memory_order_relaxed);
+		Zone& zone = buffer.m_Zones[head & (Profiler::s_ThreadCapacity - 1)];
+
+		// keeps the zone from becoming visible before the previous head, see CopyZones
+		std::atomic_thread_fence(std::memory_order_release);
+
+		zone.m_Name.store(m_Name, std::memory_order_relaxed);
+		zone.m_Start.store(m_Start, std::memory_order_relaxed);
+		zone.m_End.store(end, std::memory_order_relaxed);
+		zone.m_Depth.store(--buffer.m_Depth, std::memory_order_relaxed);
+
+		buffer.m_Head.store(head + 1, std::memory_order_release);
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace FoxoCraft
+{
+	// Scoped CPU timing zones, see FC_PROFILE_SCOPE in Log.h
+	// Every thread records finished zones into its own ring buffer without locking, the oldest zones are overwritten
+	// Buffers outlive their threads so zones of finished workers can still be exported
+	namespace Profiler
+	{
+		// zones kept per thread
+		inline constexpr size_t s_ThreadCapacity = 8192;
+
+		struct Event
+		{
+			const char* m_Name = nullptr;
+
+			// nanoseconds since the profiler started
+			uint64_t m_Start = 0;
+			uint64_t m_End = 0;
+
+			// index into GetThreadNames, nesting depth on that thread
+			uint32_t m_Thread = 0;
+			uint32_t m_Depth = 0;
+		};
+
+		// Nanoseconds since the profiler started
+		uint64_t Now();
+
+		// Names the calling thread in the flame view and in traces
+		void SetThreadName(const std::string& name);
+
+		// Marks the start of a frame, main thread only
+		void BeginFrame();
+
+		// Start and end of the last finished frame, false before the second BeginFrame, main thread only
+		bool GetLastFrame(uint64_t& begin, uint64_t& end);
+
+		// Appends the recorded zones of every thread that overlap begin to end, may be called from any thread
+		void Collect(uint64_t begin, uint64_t end, std::vector<Event>& events);
+
+		std::vector<std::string> GetThreadNames();
+
+		// Writes every recorded zone as Chrome trace event JSON, open it in chrome://tracing or Perfetto
+		bool ExportChromeTrace(const std::filesystem::path& path);
+	}
+
+	// Records a zone from construction to destruction, name must outlive the profiler, a string literal
+	class ProfileScope final
+	{
+	public:
+		explicit ProfileScope(const char* name);
+		~ProfileScope();
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+	private:
+		const char* m_Name;
+		uint64_t m_Start;
+	};
+}
@@ -0,0 +1,257 @@
+#include "RegionFile.h"
+
+#include <vector>
+
+#include "Log.h"
+
+namespace FoxoCraft
+{
+	// compacting rewrites the whole file, only do it once there is a meaningful amount to reclaim
+	static constexpr uint64_t s_CompactThreshold = 1 << 20;
+
+	glm::ivec3 RegionFile::GetRegionPos(glm::ivec3 cs)
+	{
+		return glm::ivec3(glm::floor(glm::vec3(cs) / static_cast<float>(s_RegionSize)));
+	}
+
+	size_t RegionFile::GetIndex(glm::ivec3 cs)
+	{
+		glm::ivec3 local = cs - GetRegionPos(cs) * s_RegionSize;
+		return (local.z * s_RegionSize + local.y) * s_RegionSize + local.x;
+	}
+
+	bool RegionFile::Open(const std::filesystem::path& path, bool create)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		m_Path = path;
+
+		std::error_code error;
+		if (!std::filesystem::exists(path, error))
+		{
+			if (!create) return false;
+
+			std::ofstream file(path, std::ios::binary | std::ios::trunc);
+			file.write(reinterpret_cast<const char*>(&s_Magic), sizeof(s_Magic));
+			file.write(reinterpret_cast<const char*>(&s_Version), sizeof(s_Version));
+			file.write(reinterpret_cast<const char*>(m_Entries.data()), sizeof(m_Entries));
+
+			if (!file)
+			{
+				FC_LOG_ERROR("Failed to create region file {}", path.u8string());
+				return false;
+			}
+		}
+
+		m_File.open(path, std::ios::binary | std::ios::in | std::ios::out);
+
+		uint32_t magic = 0;
+		uint32_t version = 0;
+		m_File.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+		m_File.read(reinterpret_cast<char*>(&version), sizeof(version));
+		m_File.read(reinterpret_cast<char*>(m_Entries.data()), sizeof(m_Entries));
+
+		if (!m_File || magic != s_Magic || version != s_Version)
+		{
+			FC_LOG_ERROR("Failed to open region file {}", path.u8string());
+			m_File.close();
+			return false;
+		}
+
+		m_File.seekg(0, std::ios::end);
+		m_End = static_cast<uint64_t>(m_File.tellg());
+
+		// a torn or foreign file may point into the table or past the end, those chunks are dropped and regenerated
+		size_t dropped = 0;
+		uint64_t live = 0;
+
+		for (Entry& entry : m_Entries)
+		{
+			if (entry.m_Offset == 0 && entry.m_Size == 0) continue;
+
+			if (entry.m_Offset < s_HeaderSize || entry.m_Offset + static_cast<uint64_t>(entry.m_Size) > m_End)
+			{
+				entry = {};
+				++dropped;
+				continue;
+			}
+
+			live += entry.m_Size;
+		}
+
+		if (dropped)
+			FC_LOG_WARN("Dropped {} invalid chunk entries from region file {}", dropped, path.u8string());
+
+		// overlapping entries can still add up to more than the file holds
+		m_Garbage = live < m_End - s_HeaderSize ? m_End - s_HeaderSize - live : 0;
+		return true;
+	}
+
+	bool RegionFile::Read(size_t index, ChunkPayload& payload)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		const Entry& entry = m_Entries[index];
+		if (entry.m_Offset == 0) return false;
+
+		if (!m_Mapping || static_cast<size_t>(entry.m_Offset) + entry.m_Size > m_Mapping->GetSize())
+		{
+			auto mapping = std::make_shared<MappedFile>();
+
+			if (!mapping->Open(m_Path))
+			{
+				m_Mapping.reset();
+				return false;
+			}
+
+			m_Mapping = std::move(mapping);
+		}
+
+		// the file on disk may be shorter than the table claims if something else truncated it
+		if (static_cast<size_t>(entry.m_Offset) + entry.m_Size > m_Mapping->GetSize())
+		{
+			FC_LOG_ERROR("Chunk {} reaches past the end of {}", index, m_Path.u8string());
+			return false;
+		}
+
+		payload.m_File = m_Mapping;
+		payload.m_Data = m_Mapping->GetData() + entry.m_Offset;
+		payload.m_Size = entry.m_Size;
+		return true;
+	}
+
+	bool RegionFile::Write(size_t index, const uint8_t* data, size_t size)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		// payload first, a crash in between leaves the old table entry intact
+		m_File.seekp(m_End);
+		m_File.write(reinterpret_cast<const char*>(data), size);
+		m_File.flush();
+
+		// nothing is updated for a payload that did not make it, the next write reuses the same space
+		if (!m_File)
+		{
+			FC_LOG_ERROR("Failed to write chunk {} to {}", index, m_Path.u8string());
+			m_File.clear();
+			return false;
+		}
+
+		Entry& entry = m_Entries[index];
+		m_Garbage += entry.m_Size;
+		entry.m_Offset = static_cast<uint32_t>(m_End);
+		entry.m_Size = static_cast<uint32_t>(size);
+		m_End += size;
+
+		m_File.seekp(2 * sizeof(uint32_t) + index * sizeof(Entry));
+		m_File.write(reinterpret_cast<const char*>(&entry), sizeof(Entry));
+		m_File.flush();
+
+		// the payload is in place, only the table on disk still points at the previous one
+		if (!m_File)
+		{
+			FC_LOG_ERROR("Failed to write the table entry of chunk {} to {}", index, m_Path.u8string());
+			m_File.clear();
+			return false;
+		}
+
+		// a failed compaction leaves the file as it was and the payload is written either way
+		// it is only tried again once another threshold of garbage has built up, not on every write
+		if (m_Garbage > s_CompactThreshold + m_CompactDelay && m_Garbage > m_End - s_HeaderSize - m_Garbage)
+			m_CompactDelay = Compact() ? 0 : m_Garbage;
+
+		return true;
+	}
+
+	bool RegionFile::Compact()
+	{
+		std::filesystem::path temp = m_Path;
+		temp += ".tmp";
+		std::filesystem::path old = m_Path;
+		old += ".old";
+
+		std::array<Entry, s_ChunkCount> entries = {};
+		uint64_t end = s_HeaderSize;
+		std::error_code error;
+
+		{
+			std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+			file.seekp(s_HeaderSize);
+
+			std::vector<uint8_t> payload;
+
+			for (size_t i = 0; i < s_ChunkCount; ++i)
+			{
+				if (m_Entries[i].m_Offset == 0) continue;
+
+				payload.resize(m_Entries[i].m_Size);
+				m_File.seekg(m_Entries[i].m_Offset);
+				m_File.read(reinterpret_cast<char*>(payload.data()), payload.size());
+				file.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+
+				entries[i] = { static_cast<uint32_t>(end), m_Entries[i].m_Size };
+				end += payload.size();
+			}
+
+			file.seekp(0);
+			file.write(reinterpret_cast<const char*>(&s_Magic), sizeof(s_Magic));
+			file.write(reinterpret_cast<const char*>(&s_Version), sizeof(s_Version));
+			file.write(reinterpret_cast<const char*>(entries.data()), sizeof(entries));
+
+			if (!m_File || !file)
+			{
+				FC_LOG_ERROR("Failed to compact region file {}", m_Path.u8string());
+				m_File.clear();
+				file.close();
+				std::filesystem::remove(temp, error);
+				return false;
+			}
+		}
+
+		// the file is about to be replaced, readers holding the old mapping keep the old contents
+		m_Mapping.reset();
+		m_File.close();
+
+		// Windows cannot replace a file another thread still has mapped, but it can rename it
+		// so the old file is moved aside first and only deleted once the new one is in place
+		std::filesystem::remove(old, error);
+		std::filesystem::rename(m_Path, old, error);
+
+		if (!error)
+		{
+			std::filesystem::rename(temp, m_Path, error);
+
+			// put the old file back, its table still matches m_Entries
+			if (error)
+			{
+				std::error_code restore;
+				std::filesystem::rename(old, m_Path, restore);
+			}
+		}
+
+		if (error)
+		{
+			FC_LOG_ERROR("Failed to replace region file {}: {}", m_Path.u8string(), error.message());
+			std::filesystem::remove(temp, error);
+			m_File.open(m_Path, std::ios::binary | std::ios::in | std::ios::out);
+			return false;
+		}
+
+		// still mapped by a reader on Windows, the delete then completes once its last mapping is gone
+		std::filesystem::remove(old, error);
+
+		m_Entries = entries;
+		m_End = end;
+		m_Garbage = 0;
+
+		m_File.open(m_Path, std::ios::binary | std::ios::in | std::ios::out);
+
+		if (!m_File)
+		{
+			FC_LOG_ERROR("Failed to reopen region file {}", m_Path.u8string());
+			return false;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+#include <glm/glm.hpp>
+
+#include "MappedFile.h"
+
+namespace FoxoCraft
+{
+	// Bytes of a chunk inside a mapped region file, holds on to the mapping until it is destroyed
+	struct ChunkPayload
+	{
+		std::shared_ptr<const MappedFile> m_File;
+		const uint8_t* m_Data = nullptr;
+		size_t m_Size = 0;
+	};
+
+	// Stores the payloads of a 16x16x16 block of chunks in one file
+	// The file starts with a table of offset and size for every chunk followed by the payloads
+	// Writes append the new payload and then update the table, the old payload is left as garbage
+	// until the garbage outweighs the live data and the file is rewritten
+	// Reads come straight from a memory mapping of the file, it is remapped when a read reaches past it
+	// All functions are thread safe
+	class RegionFile final
+	{
+	public:
+		static constexpr int s_RegionSize = 16;
+		static constexpr size_t s_ChunkCount = s_RegionSize * s_RegionSize * s_RegionSize;
+
+		static glm::ivec3 GetRegionPos(glm::ivec3 cs);
+
+		// Index of the chunk inside its region
+		static size_t GetIndex(glm::ivec3 cs);
+
+		// Opens an existing region file, or creates an empty one if create is set
+		bool Open(const std::filesystem::path& path, bool create);
+
+		// Points payload at the bytes of a chunk, returns false if it was never written
+		// Only the lookup is serialized, decoding the payload does not block other threads
+		bool Read(size_t index, ChunkPayload& payload);
+
+		bool Write(size_t index, const uint8_t* data, size_t size);
+	private:
+		struct Entry
+		{
+			uint32_t m_Offset = 0;
+			uint32_t m_Size = 0;
+		};
+
+		static constexpr uint32_t s_Magic = 0x47524346; // FCRG
+		static constexpr uint32_t s_Version = 1;
+		static constexpr size_t s_HeaderSize = 2 * sizeof(uint32_t) + s_ChunkCount * sizeof(Entry);
+
+		// Rewrites the file with only the live payloads, returns false and keeps the current file if that fails
+		bool Compact();
+
+		std::mutex m_Mutex;
+		std::filesystem::path m_Path;
+		std::fstream m_File;
+		std::array<Entry, s_ChunkCount> m_Entries = {};
+
+		// replaced instead of modified, readers may still hold the previous mapping
+		std::shared_ptr<const MappedFile> m_Mapping;
+
+		// end of the file and the bytes in it no entry points to
+		uint64_t m_End = s_HeaderSize;
+		uint64_t m_Garbage = 0;
+
+		// garbage at the last failed compaction, the next attempt waits for more on top of it
+		uint64_t m_CompactDelay = 0;
+	};
+}
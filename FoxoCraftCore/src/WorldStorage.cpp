@@ -0,0 +1,252 @@
+#include "WorldStorage.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "ByteStream.h"
+#include "Chunk.h"
+#include "Compression.h"
+#include "Log.h"
+
+namespace FoxoCraft
+{
+	static constexpr uint32_t s_InfoMagic = 0x44574346; // FCWD
+	static constexpr uint32_t s_InfoVersion = 1;
+
+	// largest chunk BlockStorage::Serialize can produce: bits and palette size, a full palette and 16 bit indices
+	static constexpr size_t s_MaxChunkData = 3 + 2 * 65536 + s_ChunkSize3 * 16 / 8;
+
+	WorldStorage::WorldStorage(const std::filesystem::path& directory)
+		: m_Directory(directory)
+	{
+		std::error_code error;
+		std::filesystem::create_directories(m_Directory / "region", error);
+
+		if (error)
+			FC_LOG_ERROR("Failed to create world directory {}: {}", m_Directory.u8string(), error.message());
+	}
+
+	WorldStorage::InfoResult WorldStorage::LoadInfo(int64_t& seed)
+	{
+		m_BlockNames.clear();
+
+		std::filesystem::path path = m_Directory / "world.dat";
+		// a world.dat that cannot even be checked for is treated like a corrupt one, nothing gets removed
+		std::error_code error;
+		bool exists = std::filesystem::exists(path, error) || error;
+
+		// region files without a world.dat belong to an unknown seed and block list, a new world must not load them
+		// world.dat may only have been lost, so they are kept under another name instead of deleted
+		std::filesystem::path region = m_Directory / "region";
+
+		if (!exists && !std::filesystem::is_empty(region, error) && !error)
+		{
+			std::filesystem::path aside = MoveAside(region, ".orphaned", error);
+
+			// the new world would load them, better to not start it at all
+			if (error)
+			{
+				FC_LOG_ERROR("Failed to move the region files of {} aside: {}", m_Directory.u8string(), error.message());
+				exists = true;
+			}
+			else
+			{
+				FC_LOG_WARN("{} has no world info, moved its region files to {}", m_Directory.u8string(), aside.u8string());
+				std::filesystem::create_directories(region, error);
+			}
+		}
+
+		std::ifstream file(path, std::ios::binary);
+		std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		ByteReader reader(data.data(), data.size());
+		bool loaded = exists && file.is_open() && reader.Read<uint32_t>() == s_InfoMagic && reader.Read<uint32_t>() == s_InfoVersion;
+
+		if (loaded)
+		{
+			seed = reader.Read<int64_t>();
+			uint32_t count = reader.Read<uint32_t>();
+
+			for (uint32_t i = 0; i < count && !reader.m_Failed; ++i)
+			{
+				std::string name(reader.Read<uint16_t>(), '\0');
+				reader.ReadBytes(name.data(), name.size());
+				m_BlockNames.push_back(std::move(name));
+			}
+
+			if (reader.m_Failed)
+			{
+				m_BlockNames.clear();
+				loaded = false;
+			}
+		}
+
+		InfoResult result = loaded ? InfoResult::Loaded : exists ? InfoResult::Corrupt : InfoResult::New;
+
+		if (result == InfoResult::Corrupt)
+			FC_LOG_ERROR("World info in {} is corrupt", m_Directory.u8string());
+
+		// blocks keep their saved index, new blocks are appended
+		m_ToBlock.assign(m_BlockNames.size(), s_AirBlock);
+		m_ToSaved.assign(GetBlockCount(), 0);
+
+		for (size_t id = 0; id < GetBlockCount(); ++id)
+		{
+			const std::string& name = GetBlockInfo(static_cast<BlockId>(id)).m_Name;
+			size_t index = std::find(m_BlockNames.begin(), m_BlockNames.end(), name) - m_BlockNames.begin();
+
+			if (index == m_BlockNames.size())
+			{
+				m_BlockNames.push_back(name);
+				m_ToBlock.push_back(s_AirBlock);
+			}
+
+			m_ToBlock[index] = static_cast<BlockId>(id);
+			m_ToSaved[id] = static_cast<uint16_t>(index);
+		}
+
+		return result;
+	}
+
+	std::filesystem::path WorldStorage::MoveAside(const std::filesystem::path& path, const std::string& suffix, std::error_code& error)
+	{
+		std::filesystem::path aside = path;
+		aside += suffix;
+
+		for (int i = 1; std::filesystem::exists(aside, error); ++i)
+		{
+			aside = path;
+			aside += suffix + std::to_string(i);
+		}
+
+		if (!error)
+			std::filesystem::rename(path, aside, error);
+
+		return error ? std::filesystem::path() : aside;
+	}
+
+	bool WorldStorage::SaveInfo(int64_t seed)
+	{
+		std::vector<uint8_t> data;
+		ByteWriter writer(data);
+		writer.Write(s_InfoMagic);
+		writer.Write(s_InfoVersion);
+		writer.Write(seed);
+		writer.Write(static_cast<uint32_t>(m_BlockNames.size()));
+
+		for (const std::string& name : m_BlockNames)
+		{
+			writer.Write(static_cast<uint16_t>(name.size()));
+			writer.WriteBytes(name.data(), name.size());
+		}
+
+		// written next to it and renamed over it, a crash or full disk mid write must not leave a short world.dat behind
+		std::filesystem::path path = m_Directory / "world.dat";
+		std::filesystem::path temp = m_Directory / "world.dat.tmp";
+
+		{
+			std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+			file.write(reinterpret_cast<const char*>(data.data()), data.size());
+			file.flush();
+
+			if (!file)
+			{
+				FC_LOG_ERROR("Failed to write world info to {}", m_Directory.u8string());
+				file.close();
+				std::error_code error;
+				std::filesystem::remove(temp, error);
+				return false;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(temp, path, error);
+
+		if (error)
+		{
+			FC_LOG_ERROR("Failed to replace world info in {}: {}", m_Directory.u8string(), error.message());
+			std::filesystem::remove(temp, error);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool WorldStorage::LoadChunk(glm::ivec3 cs, BlockStorage& storage)
+	{
+		FC_PROFILE_SCOPE("Load chunk");
+
+		RegionFile* region = GetRegion(cs, false);
+		if (!region) return false;
+
+		ChunkPayload payload;
+		if (!region->Read(RegionFile::GetIndex(cs), payload)) return false;
+
+		// decompressed straight from the mapping into a per thread buffer, nothing is copied out of the file first
+		static thread_local std::vector<uint8_t> data;
+
+		ByteReader reader(payload.m_Data, payload.m_Size);
+		uint32_t size = reader.Read<uint32_t>();
+
+		// a damaged size must not make a worker allocate gigabytes, or keep them in its buffer for the rest of the run
+		if (reader.m_Failed || size > s_MaxChunkData)
+		{
+			FC_LOG_ERROR("Chunk {} {} {} is corrupt", cs.x, cs.y, cs.z);
+			return false;
+		}
+
+		data.resize(size);
+
+		if (!Compression::Decompress(payload.m_Data + reader.m_Pos, payload.m_Size - reader.m_Pos, data.data(), data.size())
+			|| !storage.Deserialize(data.data(), data.size(), m_ToBlock))
+		{
+			FC_LOG_ERROR("Chunk {} {} {} is corrupt", cs.x, cs.y, cs.z);
+			return false;
+		}
+
+		++m_ChunksLoaded;
+		return true;
+	}
+
+	bool WorldStorage::SaveChunk(glm::ivec3 cs, const BlockStorage& storage)
+	{
+		FC_PROFILE_SCOPE("Save chunk");
+
+		RegionFile* region = GetRegion(cs, true);
+		if (!region) return false;
+
+		std::vector<uint8_t> data;
+		storage.Serialize(data, m_ToSaved);
+
+		std::vector<uint8_t> payload;
+		ByteWriter writer(payload);
+		writer.Write(static_cast<uint32_t>(data.size()));
+		Compression::Compress(data.data(), data.size(), payload);
+
+		if (!region->Write(RegionFile::GetIndex(cs), payload.data(), payload.size())) return false;
+
+		++m_ChunksSaved;
+		m_BytesWritten += payload.size();
+		return true;
+	}
+
+	RegionFile* WorldStorage::GetRegion(glm::ivec3 cs, bool create)
+	{
+		glm::ivec3 rs = RegionFile::GetRegionPos(cs);
+
+		std::lock_guard<std::mutex> lock(m_RegionsMutex);
+
+		std::unique_ptr<RegionFile>* cached = m_Regions.Find(rs);
+		if (cached && (*cached || !create)) return cached->get();
+
+		auto region = std::make_unique<RegionFile>();
+		std::filesystem::path path = m_Directory / "region" / ("r." + std::to_string(rs.x) + "." + std::to_string(rs.y) + "." + std::to_string(rs.z) + ".fcr");
+
+		if (!region->Open(path, create))
+			region.reset();
+
+		return m_Regions.Insert(rs, std::move(region)).get();
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <system_error>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Block.h"
+#include "BlockStorage.h"
+#include "ChunkMap.h"
+#include "RegionFile.h"
+
+namespace FoxoCraft
+{
+	// Save directory of a world
+	// world.dat holds the seed and the names of every block ever saved, chunk palettes store indices into that list
+	// so worlds survive blocks being added or removed. Chunks are compressed and kept in region files under region/
+	// Chunks are saved once when they are first generated and again whenever they change, from then on they are loaded instead of generated
+	class WorldStorage final
+	{
+	public:
+		enum class InfoResult
+		{
+			Loaded,
+			// world.dat does not exist, region files left without it are moved aside to region.orphaned
+			New,
+			// world.dat exists but could not be read, or orphaned region files could not be moved aside
+			// nothing is touched and the world must not be saved over
+			Corrupt
+		};
+
+		WorldStorage(const std::filesystem::path& directory);
+
+		// Reads world.dat and merges the registered blocks into its block list
+		// Must be called after LockModify and before any chunk is loaded
+		InfoResult LoadInfo(int64_t& seed);
+		bool SaveInfo(int64_t seed);
+
+		// Renames path to path + suffix, numbered when that is taken, returns the new path or an empty one on error
+		static std::filesystem::path MoveAside(const std::filesystem::path& path, const std::string& suffix, std::error_code& error);
+
+		// Thread safe, returns false if the chunk was never saved
+		bool LoadChunk(glm::ivec3 cs, BlockStorage& storage);
+		bool SaveChunk(glm::ivec3 cs, const BlockStorage& storage);
+
+		std::atomic<size_t> m_ChunksLoaded = 0;
+		std::atomic<size_t> m_ChunksSaved = 0;
+		std::atomic<size_t> m_BytesWritten = 0;
+	private:
+		// nullptr if the region file does not exist and create is not set
+		RegionFile* GetRegion(glm::ivec3 cs, bool create);
+
+		std::filesystem::path m_Directory;
+
+		// saved block index to BlockId and back
+		std::vector<std::string> m_BlockNames;
+		std::vector<BlockId> m_ToBlock;
+		std::vector<uint16_t> m_ToSaved;
+
+		// missing region files are cached as nullptr so loads of unsaved areas do not touch the disk
+		std::mutex m_RegionsMutex;
+		ChunkMap<std::unique_ptr<RegionFile>> m_Regions;
+	};
+}
@@ -30,6 +30,7 @@ project "FoxoCraft"
 
 	includedirs
 	{
+		"%{wks.location}/FoxoCraftCore/src",
 		"%{wks.location}/vendor/glad2/include",
 		"%{wks.location}/vendor/glfw/include",
 		"%{wks.location}/vendor/glm",
@@ -45,6 +46,7 @@ project "FoxoCraft"
 
 	links
 	{
+		"FoxoCraftCore",
 		"glad2",
 		"glfw",
 		"FoxoCommons",
@@ -78,6 +80,90 @@ project "FoxoCraft"
 		runtime "Release"
 		optimize "on"
 
+-- blocks, chunks, world generation, meshing and storage, no gl or windowing so servers and tools can use it
+project "FoxoCraftCore"
+	location "FoxoCraftCore"
+	kind "StaticLib"
+	language "C++"
+	cppdialect "C++17"
+	staticruntime "on"
+	systemversion "latest"
+
+	targetdir (outputbindir)
+	objdir (outputobjdir)
+
+	files
+	{
+		"%{prj.location}/src/**.cpp",
+		"%{prj.location}/src/**.h"
+	}
+
+	includedirs
+	{
+		"%{wks.location}/vendor/glm",
+		"%{wks.location}/vendor/spdlog/include",
+		"%{wks.location}/vendor/FoxoCommons/include"
+	}
+
+	filter "system:windows"
+		defines "SPDLOG_WCHAR_TO_UTF8_SUPPORT"
+
+	filter "configurations:Debug"
+		runtime "Debug"
+		symbols "on"
+
+	filter "configurations:Release"
+		runtime "Release"
+		optimize "on"
+
+project "FoxoCraftBench"
+	location "FoxoCraftBench"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++17"
+	staticruntime "on"
+	systemversion "latest"
+
+	targetdir (outputbindir)
+	objdir (outputobjdir)
+
+	files
+	{
+		"%{prj.location}/src/**.cpp",
+		"%{prj.location}/src/**.h"
+	}
+
+	includedirs
+	{
+		"%{wks.location}/FoxoCraftCore/src",
+		"%{wks.location}/vendor/glm",
+		"%{wks.location}/vendor/spdlog/include",
+		"%{wks.location}/vendor/FoxoCommons/include"
+	}
+
+	links
+	{
+		"FoxoCraftCore",
+		"FoxoCommons"
+	}
+
+	filter "system:windows"
+		links "psapi"
+
+	filter "system:linux"
+		linkoptions
+		{
+			"-pthread"
+		}
+
+	filter "configurations:Debug"
+		runtime "Debug"
+		symbols "on"
+
+	filter "configurations:Release"
+		runtime "Release"
+		optimize "on"
+
 group "Dependencies"
 
 project "imgui"